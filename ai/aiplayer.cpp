@@ -0,0 +1,62 @@
+#include "aiplayer.h"
+#include "pathfinder.h"
+#include "simulation.h"
+#include "inputevent.h"
+
+namespace ai {
+
+AiPlayer::AiPlayer(std::unique_ptr<ISearch> search)
+    : search_{ std::move(search) }
+{
+}
+
+void AiPlayer::play(Simulation& simulation)
+{
+	const auto& board     = simulation.board();
+	const auto  placement = this->search_->choose(simulation.state());
+	if (placement)
+	{
+		if (const auto path = find_path(board.grid(), *board.playingTetromino(), *placement))
+		{
+			for (const auto input : *path)
+			{
+				simulation.processInputEvent(input);
+			}
+			return;
+		}
+	}
+	simulation.processInputEvent(InputEvent::HARD_DROP);
+}
+
+uint64_t AiPlayer::rollouts() const
+{
+	return this->search_->rollouts();
+}
+
+std::optional<InputEvent> AiPlayer::nextInput(const GameState& state)
+{
+	const auto& board            = *state.board;
+	const auto  playingTetromino = board.playingTetromino();
+	if (!playingTetromino)
+	{
+		return std::nullopt;
+	}
+
+	// Choose once per tetromino, then keep steering towards that choice.
+	if (this->plannedPiece_ != board.pieces())
+	{
+		this->plannedPiece_ = board.pieces();
+		this->plan_         = this->search_->choose(state);
+	}
+
+	if (this->plan_)
+	{
+		if (const auto path = find_path(board.grid(), *playingTetromino, *this->plan_))
+		{
+			return path->front();
+		}
+	}
+	return InputEvent::HARD_DROP;
+}
+
+} // namespace ai
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "iplayer.h"
+#include "isearch.h"
+
+#include <memory>
+#include <optional>
+#include <cstdint>
+
+struct GameState;
+enum class InputEvent;
+
+namespace ai {
+
+// Lets a search choose where each tetromino goes, then steers the tetromino there.
+class AiPlayer final : public IPlayer
+{
+	std::unique_ptr<ISearch> search_;
+	uint32_t                 plannedPiece_{};
+	std::optional<Placement> plan_{};
+
+public:
+	explicit AiPlayer(std::unique_ptr<ISearch> search);
+
+	void     play(Simulation& simulation) override;
+	uint64_t rollouts() const override;
+
+	// For real-time play, where gravity moves the tetromino between inputs: the next input towards the placement chosen for
+	// the playing tetromino, or nullopt when there is none.
+	std::optional<InputEvent> nextInput(const GameState& state);
+};
+
+} // namespace ai
@@ -0,0 +1,66 @@
+#include "autopilot.h"
+#include "game.h"
+#include "gamestate.h"
+#include "itimer.h"
+#include "inputevent.h"
+
+namespace ai {
+
+void Autopilot::tick()
+{
+	const auto state = this->game_.snapshot();
+	if (state.board->gameOver())
+	{
+		this->game_.processInputEvent(InputEvent::NEW_GAME);
+	}
+	else if (const auto input = this->player_.nextInput(state))
+	{
+		this->game_.processInputEvent(*input);
+	}
+
+	this->timer_->start(TICK_MSEC, [this]() { this->tick(); });
+}
+
+Autopilot::Autopilot(Game& game, std::unique_ptr<ITimer> timer)
+    : game_{ game }
+    , timer_{ std::move(timer) }
+    , evaluator_{ HeuristicEvaluator::Weights::startup() }
+    , player_{ std::make_unique<BeamSearch>(this->evaluator_, BeamSearch::Options{}) }
+    , enabled_{}
+{
+}
+
+Autopilot::~Autopilot() noexcept
+{
+	this->timer_->stop();
+}
+
+bool Autopilot::enabled() const
+{
+	return this->enabled_;
+}
+
+void Autopilot::setEnabled(bool enabled)
+{
+	if (enabled == this->enabled_)
+	{
+		return;
+	}
+
+	this->enabled_ = enabled;
+	if (enabled)
+	{
+		this->timer_->start(TICK_MSEC, [this]() { this->tick(); });
+	}
+	else
+	{
+		this->timer_->stop();
+	}
+}
+
+void Autopilot::toggle()
+{
+	this->setEnabled(!this->enabled_);
+}
+
+} // namespace ai
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "aiplayer.h"
+#include "beamsearch.h"
+#include "heuristicevaluator.h"
+
+#include <memory>
+
+class Game;
+class ITimer;
+
+namespace ai {
+
+// Attract mode: lets the AI play a real-time game at a watchable pace, one input per tick, and starts a new game when it
+// tops out. Player input still reaches the game while it runs.
+class Autopilot final
+{
+	static constexpr int TICK_MSEC = 80;
+
+	Game&                   game_;
+	std::unique_ptr<ITimer> timer_;
+	HeuristicEvaluator      evaluator_;
+	AiPlayer                player_;
+	bool                    enabled_;
+
+	void tick();
+
+public:
+	Autopilot(Game& game, std::unique_ptr<ITimer> timer);
+	~Autopilot() noexcept;
+
+	bool enabled() const;
+	void setEnabled(bool enabled);
+	void toggle();
+};
+
+} // namespace ai
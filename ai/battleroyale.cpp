@@ -0,0 +1,353 @@
+#include "battleroyale.h"
+#include "opponent.h"
+#include "board.h"
+#include "gamestate.h"
+#include "inputevent.h"
+#include "splitmix64.h"
+#include "threadpool.h"
+#include "xoshiro256.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace ai {
+
+namespace {
+
+struct Attack final
+{
+	uint32_t sender;
+	int      rows;
+};
+
+// The garbage sent to a board. Any number of threads post to it at once, each claiming a slot with one fetch_add, and
+// the board takes the attacks out at the next frame. Frames alternate between the two halves, so the posts of a frame
+// never meet the board taking out those of the frame before, and the barrier between frames orders the two.
+class Inbox final
+{
+	std::array<std::vector<Attack>, 2>   slots_;
+	std::array<std::atomic<uint32_t>, 2> counts_{};
+
+public:
+	// A board locks at most twice in a frame, once by gravity and once by an input.
+	explicit Inbox(size_t boards)
+	    : slots_{ std::vector<Attack>(2 * boards), std::vector<Attack>(2 * boards) }
+	{
+	}
+
+	static size_t bytes(size_t boards)
+	{
+		return 2 * 2 * boards * sizeof(Attack);
+	}
+
+	void post(uint64_t frame, const Attack& attack)
+	{
+		auto&      slots = this->slots_[frame & 1];
+		const auto slot  = this->counts_[frame & 1].fetch_add(1, std::memory_order_relaxed);
+		if (slot >= slots.size())
+		{
+			// More attacks in a frame than the boards can make by locking twice each, which must not write past the slots.
+			throw std::logic_error{ fmt::format("the inbox of {} slots overflowed in frame {}", slots.size(), frame) };
+		}
+		slots[slot] = attack;
+	}
+
+	// Moves the attacks posted during the frame to the end of the list, in the order of their senders.
+	void take(uint64_t frame, std::vector<Attack>& attacks)
+	{
+		auto&      slots = this->slots_[frame & 1];
+		const auto count = std::min<size_t>(this->counts_[frame & 1].exchange(0, std::memory_order_relaxed), slots.size());
+		const auto first = attacks.size();
+		attacks.insert(attacks.end(), slots.begin(), slots.begin() + count);
+		std::stable_sort(attacks.begin() + first, attacks.end(), [](const Attack& a, const Attack& b) { return a.sender < b.sender; });
+	}
+};
+
+struct Seat final
+{
+	Simulation          simulation{};
+	Opponent            opponent;
+	Xoshiro256          random; // of the targets and the hole columns
+	Inbox               inbox;
+	GarbageQueue        incoming{};
+	std::vector<Attack> arrived{};
+	uint32_t            attacker{};
+	bool                attacked{};
+	uint64_t            sent{};
+
+	Seat(std::unique_ptr<ISearch> search, int pace, uint64_t paceSeed, uint64_t seed, size_t boards)
+	    : opponent{ std::move(search), pace, paceSeed }
+	    , random{ seed }
+	    , inbox{ boards }
+	{
+	}
+};
+
+// The boards playing when a frame begins, which are the ones that take part in it.
+struct Field final
+{
+	std::vector<uint32_t> playing{};
+	std::vector<uint8_t>  isPlaying{};
+};
+
+class Match final
+{
+	const BattleRoyale::Options& options_;
+	std::deque<Seat>             seats_{};
+	Field                        field_{};
+	uint64_t                     frame_{};
+
+	uint32_t target(uint32_t board)
+	{
+		auto& seat = this->seats_[board];
+		if (this->options_.targeting == BattleRoyale::Targeting::ATTACKERS && seat.attacked && this->field_.isPlaying[seat.attacker])
+		{
+			return seat.attacker;
+		}
+		const auto& playing = this->field_.playing;
+		for (;;)
+		{
+			const auto target = playing[seat.random.below(static_cast<uint32_t>(playing.size()))];
+			if (target != board)
+			{
+				return target;
+			}
+		}
+	}
+
+	void locked(uint32_t board, int linesCleared)
+	{
+		auto& seat = this->seats_[board];
+
+		const auto rows = seat.incoming.cancel(this->options_.versus.garbage[linesCleared]);
+		if (rows > 0)
+		{
+			this->seats_[this->target(board)].inbox.post(this->frame_, Attack{ board, rows });
+			seat.sent += rows;
+		}
+
+		if (linesCleared == 0)
+		{
+			seat.incoming.raise(seat.simulation, seat.random);
+		}
+	}
+
+	void step(uint32_t board)
+	{
+		auto& seat = this->seats_[board];
+
+		seat.arrived.clear();
+		seat.inbox.take(this->frame_ - 1, seat.arrived);
+		for (const auto& attack : seat.arrived)
+		{
+			seat.incoming.push(attack.rows);
+			seat.attacker = attack.sender;
+			seat.attacked = true;
+		}
+
+		seat.simulation.advanceTo(this->frame_);
+		if (const auto input = seat.opponent.act(seat.simulation.state()))
+		{
+			seat.simulation.processInputEvent(*input);
+		}
+	}
+
+	void survey()
+	{
+		this->field_.playing.clear();
+		for (uint32_t board = 0; board < this->seats_.size(); ++board)
+		{
+			const auto playing            = !this->seats_[board].simulation.board().gameOver();
+			this->field_.isPlaying[board] = playing;
+			if (playing)
+			{
+				this->field_.playing.push_back(board);
+			}
+		}
+	}
+
+public:
+	Match(const BattleRoyale::Options& options, const BattleRoyale::SearchFactory& searchFactory)
+	    : options_{ options }
+	{
+		// A seed each for the search, the pace and the targets and holes of every board, none shared with another.
+		auto seeds = options.seed;
+		for (uint32_t board = 0; board < options.boards; ++board)
+		{
+			const auto searchSeed = splitmix64(seeds);
+			const auto paceSeed   = splitmix64(seeds);
+			const auto seatSeed   = splitmix64(seeds);
+			auto&      seat       = this->seats_.emplace_back(searchFactory(searchSeed), options.pace, paceSeed, seatSeed, options.boards);
+			seat.simulation.setLockHandler([this, board](int linesCleared) { this->locked(board, linesCleared); });
+		}
+		this->field_.isPlaying.resize(options.boards);
+	}
+
+	static size_t bytesPerBoard(size_t boards)
+	{
+		return sizeof(Seat) + Inbox::bytes(boards) + sizeof(uint32_t) + sizeof(uint8_t);
+	}
+
+	void start()
+	{
+		for (auto& seat : this->seats_)
+		{
+			seat.simulation.start(this->options_.seed);
+		}
+		this->survey();
+	}
+
+	uint64_t frame() const
+	{
+		return this->frame_;
+	}
+
+	const Field& field() const
+	{
+		return this->field_;
+	}
+
+	// Brings the boards that are playing to the next frame, shard by shard.
+	void tick(ThreadPool& pool, size_t shards)
+	{
+		++this->frame_;
+		const auto& playing = this->field_.playing;
+		pool.parallelFor(shards, [&](size_t shard) {
+			const auto begin = shard * playing.size() / shards;
+			const auto end   = (shard + 1) * playing.size() / shards;
+			for (auto i = begin; i < end; ++i)
+			{
+				this->step(playing[i]);
+			}
+		});
+		this->survey();
+	}
+
+	uint64_t garbage() const
+	{
+		uint64_t rows{};
+		for (const auto& seat : this->seats_)
+		{
+			rows += seat.sent;
+		}
+		return rows;
+	}
+};
+
+size_t peak_resident_bytes()
+{
+#ifdef _WIN32
+	return 0;
+#else
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return static_cast<size_t>(usage.ru_maxrss);
+#else
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+} // namespace
+
+std::string BattleRoyaleReport::summary() const
+{
+	std::string result = fmt::format("{} boards in {} shards on {} threads, {} frames ({}:{:02}) in {:.3f} s\n",
+	                                 this->boards,
+	                                 this->shards,
+	                                 this->threads,
+	                                 this->frames,
+	                                 this->frames / Simulation::FRAMES_PER_SECOND / 60,
+	                                 this->frames / Simulation::FRAMES_PER_SECOND % 60,
+	                                 this->seconds);
+	result += this->winner ? fmt::format("board {} won", *this->winner) : fmt::format("{} boards still playing", this->playing);
+	result += fmt::format(", {} rows of garbage sent\n", this->garbage);
+	result += fmt::format("real time factor {:.2f}x\n", this->realTimeFactor);
+	result += fmt::format("us per frame  p50 {:.1f}  p90 {:.1f}  p99 {:.1f}  max {:.1f}   of {:.1f}",
+	                      this->tickP50,
+	                      this->tickP90,
+	                      this->tickP99,
+	                      this->tickMax,
+	                      1e6 / Simulation::FRAMES_PER_SECOND);
+	result += this->lateTicks ? fmt::format(", {} frames late\n", this->lateTicks) : "\n";
+	result += fmt::format("bytes per board  {} kept by the harness", this->bytesPerBoard);
+	if (this->residentBytesPerBoard)
+	{
+		result += fmt::format(", {} resident with the search", this->residentBytesPerBoard);
+	}
+	result += '\n';
+	return result;
+}
+
+BattleRoyaleReport BattleRoyale::run(ThreadPool& pool, const Options& options, const SearchFactory& searchFactory)
+{
+	using Clock = std::chrono::steady_clock;
+
+	assert(options.boards >= 2);
+
+	const auto residentBefore = peak_resident_bytes();
+	Match      match{ options, searchFactory };
+	match.start();
+
+	// A few shards per thread, so that a thread whose boards are all searching at once does not hold up the frame.
+	const auto shards = std::min<size_t>(options.boards, 4 * pool.size());
+
+	const auto          frameTime = std::chrono::duration<double>(1.0 / Simulation::FRAMES_PER_SECOND);
+	std::vector<double> ticks{};
+	uint64_t            lateTicks{};
+	const auto          started = Clock::now();
+	while (match.field().playing.size() > 1 && match.frame() < options.maxFrames)
+	{
+		const auto due = started + std::chrono::duration_cast<Clock::duration>(frameTime * static_cast<double>(match.frame() + 1));
+		if (options.realTime)
+		{
+			std::this_thread::sleep_until(due - std::chrono::duration_cast<Clock::duration>(frameTime));
+		}
+		const auto tickStarted = Clock::now();
+		match.tick(pool, shards);
+		const auto tickEnded = Clock::now();
+		ticks.push_back(std::chrono::duration<double, std::micro>(tickEnded - tickStarted).count());
+		lateTicks += options.realTime && tickEnded > due;
+	}
+
+	BattleRoyaleReport report{};
+	report.boards  = options.boards;
+	report.threads = pool.size();
+	report.shards  = shards;
+	report.frames  = match.frame();
+	report.playing = match.field().playing.size();
+	report.winner  = report.playing == 1 ? std::optional<size_t>{ match.field().playing.front() } : std::nullopt;
+	report.garbage = match.garbage();
+	report.seconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+	const auto busy       = std::accumulate(ticks.begin(), ticks.end(), 0.0) / 1e6;
+	report.realTimeFactor = busy > 0 ? static_cast<double>(report.frames) / Simulation::FRAMES_PER_SECOND / busy : 0;
+	std::sort(ticks.begin(), ticks.end());
+	report.tickP50   = Distribution::percentile(ticks, 0.5);
+	report.tickP90   = Distribution::percentile(ticks, 0.9);
+	report.tickP99   = Distribution::percentile(ticks, 0.99);
+	report.tickMax   = ticks.empty() ? 0 : ticks.back();
+	report.lateTicks = lateTicks;
+
+	const auto residentAfter     = peak_resident_bytes();
+	report.bytesPerBoard         = Match::bytesPerBoard(options.boards);
+	report.residentBytesPerBoard = residentAfter > residentBefore ? (residentAfter - residentBefore) / options.boards : 0;
+	return report;
+}
+
+} // namespace ai
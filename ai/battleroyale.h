@@ -0,0 +1,77 @@
+#pragma once
+
+#include "isearch.h"
+#include "simulation.h"
+#include "versus.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+namespace ai {
+
+struct BattleRoyaleReport final
+{
+	size_t                boards;
+	unsigned              threads;
+	size_t                shards;
+	uint64_t              frames;
+	std::optional<size_t> winner;
+	size_t                playing; // boards still playing at the end
+	uint64_t              garbage; // rows sent by all boards
+	double                seconds;
+
+	// Seconds of play per second the frames took to step. Below 1 the boards fall behind the wall clock.
+	double realTimeFactor;
+	// Microseconds to step all boards by one frame.
+	double tickP50, tickP90, tickP99, tickMax;
+	// Frames that were done only after they were due, when keeping to the wall clock.
+	uint64_t lateTicks;
+
+	// What the harness keeps for each board, without its search, and the growth of the peak resident set of the process
+	// over the match per board, searches included (0 where the platform does not tell).
+	size_t bytesPerBoard;
+	size_t residentBytesPerBoard;
+
+	std::string summary() const;
+};
+
+// A battle royale: many boards dealt the same tetrominoes, each played by an Opponent, sending garbage to each other as
+// in Versus until one is left. The boards are split into shards that a thread pool steps one frame at a time, so a
+// frame of all boards takes a fraction of its sixtieth of a second when there are cores to spare.
+//
+// Garbage goes through an inbox per board that any thread may post to without a lock. An attack made during a frame is
+// taken out of the inbox at the next one, and ordered by sender, and every board picks its targets among the boards
+// that were playing when the frame began, so the match comes out the same however the shards fall on the threads.
+class BattleRoyale final
+{
+public:
+	using SearchFactory = std::function<std::unique_ptr<ISearch>(uint64_t seed)>;
+
+	enum class Targeting
+	{
+		RANDOM,   // any other board still playing
+		ATTACKERS // the board that attacked last, or any when that one is out
+	};
+
+	struct Options final
+	{
+		size_t          boards = 99;
+		uint64_t        seed   = 1;
+		Versus::Options versus{};
+		Targeting       targeting = Targeting::RANDOM;
+		int             pace      = 6; // frames between the inputs of an opponent
+		uint64_t        maxFrames = 10 * 60 * Simulation::FRAMES_PER_SECOND;
+		// Waits for the wall clock before every frame, as a server hosting people would, rather than playing flat out.
+		bool realTime{};
+	};
+
+	static BattleRoyaleReport run(ThreadPool& pool, const Options& options, const SearchFactory& searchFactory);
+};
+
+} // namespace ai
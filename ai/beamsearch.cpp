@@ -0,0 +1,193 @@
+#include "beamsearch.h"
+#include "movegenerator.h"
+#include "ievaluator.h"
+#include "threadpool.h"
+#include "transpositiontable.h"
+#include "gridposition.h"
+#include "gamestate.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+
+namespace ai {
+
+void BeamSearch::expand(const Node& parent, TetrominoType type, bool root, std::vector<Node>& children) const
+{
+	thread_local MoveGenerator generator{};
+
+	children.clear();
+	for (const auto& placement : generator.generate(parent.grid, type))
+	{
+		auto child = Node{ parent.grid, 0.0, parent.linesCleared, root ? placement : parent.first };
+		child.grid.place(Tetromino{ type, placement.rotation }, GridPosition{ placement.row, placement.column });
+		child.linesCleared += child.grid.clearFullLines();
+		children.push_back(child);
+	}
+	this->evaluate(children);
+}
+
+void BeamSearch::evaluate(std::vector<Node>& nodes) const
+{
+	thread_local std::vector<size_t>      pending{};
+	thread_local std::vector<uint64_t>    keys{};
+	thread_local std::vector<const Grid*> grids{};
+	thread_local std::vector<int>         linesCleared{};
+	thread_local std::vector<double>      scores{};
+
+	pending.clear();
+	keys.clear();
+	grids.clear();
+	linesCleared.clear();
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		auto& node = nodes[i];
+		if (this->table_)
+		{
+			const auto key = TranspositionTable::key(node.grid, node.linesCleared, this->evaluator_.symmetric());
+			if (const auto score = this->table_->probe(key))
+			{
+				node.score = *score;
+				continue;
+			}
+			keys.push_back(key);
+		}
+		pending.push_back(i);
+		grids.push_back(&node.grid);
+		linesCleared.push_back(node.linesCleared);
+	}
+
+	scores.resize(pending.size());
+	this->evaluator_.evaluateBatch(grids.data(), linesCleared.data(), scores.data(), pending.size());
+	for (size_t k = 0; k < pending.size(); ++k)
+	{
+		nodes[pending[k]].score = scores[k];
+		if (this->table_)
+		{
+			this->table_->store(keys[k], scores[k]);
+		}
+	}
+}
+
+BeamSearch::BeamSearch(const IEvaluator& evaluator, const Options& options, ThreadPool* pool, TranspositionTable* table)
+    : evaluator_{ evaluator }
+    , options_{ options }
+    , pool_{ pool }
+    , table_{ table }
+    , beam_{}
+    , next_{}
+    , children_{}
+    , order_{}
+    , tetrominoes_{}
+{
+	assert(options.width > 0 && options.depth > 0);
+}
+
+const BeamSearch::Options& BeamSearch::options() const
+{
+	return this->options_;
+}
+
+std::optional<Placement> BeamSearch::search(const Grid& grid, const std::vector<TetrominoType>& tetrominoes)
+{
+	const auto depth = std::min(this->options_.depth, static_cast<int>(tetrominoes.size()));
+	if (depth == 0)
+	{
+		return std::nullopt;
+	}
+
+	this->beam_.assign(1, Node{ grid, 0.0, 0, Placement{} });
+	for (int level = 0; level < depth; ++level)
+	{
+		const auto type = tetrominoes[level];
+		const auto root = level == 0;
+
+		if (this->children_.size() < this->beam_.size())
+		{
+			this->children_.resize(this->beam_.size());
+		}
+
+		const auto expand = [&](size_t i) { this->expand(this->beam_[i], type, root, this->children_[i]); };
+		if (this->pool_ && this->beam_.size() > 1)
+		{
+			this->pool_->parallelFor(this->beam_.size(), expand);
+		}
+		else
+		{
+			for (size_t i = 0; i < this->beam_.size(); ++i)
+			{
+				expand(i);
+			}
+		}
+
+		// Nodes whose successor cannot enter the grid have no children and drop out of the beam here.
+		const auto parents = this->beam_.size();
+		this->beam_.clear();
+		for (size_t i = 0; i < parents; ++i)
+		{
+			this->beam_.insert(this->beam_.end(), this->children_[i].begin(), this->children_[i].end());
+		}
+		if (this->beam_.empty())
+		{
+			break;
+		}
+
+		// Equal grids have equal scores, so after sorting they are neighbours and the first of them is kept. The sort is
+		// stable, which keeps the outcome independent of how the expansion was spread over threads. Nodes are large, so
+		// their indices are sorted instead.
+		this->order_.resize(this->beam_.size());
+		std::iota(this->order_.begin(), this->order_.end(), size_t{ 0 });
+		std::stable_sort(this->order_.begin(), this->order_.end(), [this](size_t a, size_t b) {
+			const auto& x = this->beam_[a];
+			const auto& y = this->beam_[b];
+			return x.score != y.score ? x.score > y.score : x.grid.hash() < y.grid.hash();
+		});
+		this->next_.clear();
+		for (const auto i : this->order_)
+		{
+			const auto& node = this->beam_[i];
+			if (static_cast<int>(this->next_.size()) == this->options_.width)
+			{
+				break;
+			}
+			if (this->next_.empty() || this->next_.back().grid.hash() != node.grid.hash() ||
+			    this->next_.back().linesCleared != node.linesCleared)
+			{
+				this->next_.push_back(node);
+			}
+		}
+		this->beam_.swap(this->next_);
+	}
+
+	// When every line of play dies before the search depth, fall back on the best first placement.
+	if (this->beam_.empty())
+	{
+		this->beam_.assign(1, Node{ grid, 0.0, 0, Placement{} });
+		this->expand(this->beam_.front(), tetrominoes.front(), true, this->children_.front());
+		if (this->children_.front().empty())
+		{
+			return std::nullopt;
+		}
+		this->beam_.swap(this->children_.front());
+	}
+
+	const auto best = std::max_element(this->beam_.begin(), this->beam_.end(), [](const Node& a, const Node& b) { return a.score < b.score; });
+	return best->first;
+}
+
+std::optional<Placement> BeamSearch::choose(const GameState& state)
+{
+	const auto playingTetromino = state.board->playingTetromino();
+	if (!playingTetromino)
+	{
+		return std::nullopt;
+	}
+
+	this->tetrominoes_.clear();
+	this->tetrominoes_.push_back(playingTetromino->tetromino().type());
+	this->tetrominoes_.push_back(state.board->nextTetromino().type());
+
+	return this->search(state.board->grid(), this->tetrominoes_);
+}
+
+} // namespace ai
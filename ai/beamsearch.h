@@ -0,0 +1,66 @@
+#pragma once
+
+#include "isearch.h"
+#include "grid.h"
+
+#include <optional>
+#include <vector>
+
+class ThreadPool;
+
+namespace ai {
+
+class IEvaluator;
+class TranspositionTable;
+
+// Looks ahead over a known sequence of tetrominoes (the playing one and the preview): every placement of the first one is
+// scored, the best `width` boards are kept, each of those is expanded with the next tetromino, and so on up to `depth`
+// tetrominoes. The beam is expanded on the thread pool when one is given, and the placements of each expanded node are scored
+// in one batch.
+//
+// Different placement orders often build the same grid. Such duplicates are kept in the beam only once, and with a
+// transposition table, which may be shared with other searches, a grid is evaluated once across all of them.
+class BeamSearch final : public ISearch
+{
+public:
+	struct Options final
+	{
+		int width = 8;
+		int depth = 2; // limited to the number of known tetrominoes
+	};
+
+private:
+	struct Node final
+	{
+		Grid      grid;
+		double    score;
+		int       linesCleared;
+		Placement first; // the placement of the first tetromino this node descends from
+	};
+
+	const IEvaluator&              evaluator_;
+	Options                        options_;
+	ThreadPool*                    pool_;
+	TranspositionTable*            table_;
+	std::vector<Node>              beam_;
+	std::vector<Node>              next_;
+	std::vector<std::vector<Node>> children_;
+	std::vector<size_t>            order_;
+	std::vector<TetrominoType>     tetrominoes_;
+
+	void evaluate(std::vector<Node>& nodes) const;
+	void   expand(const Node& parent, TetrominoType type, bool root, std::vector<Node>& children) const;
+
+public:
+	BeamSearch(const IEvaluator& evaluator, const Options& options, ThreadPool* pool = nullptr, TranspositionTable* table = nullptr);
+
+	const Options& options() const;
+
+	// The placement of tetrominoes.front() that leads to the best board, or nullopt when it cannot enter the grid.
+	std::optional<Placement> search(const Grid& grid, const std::vector<TetrominoType>& tetrominoes);
+
+	// Searches over the playing and the next tetromino.
+	std::optional<Placement> choose(const GameState& state) override;
+};
+
+} // namespace ai
@@ -0,0 +1,284 @@
+#include "boardfeatures.h"
+#include "bits.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace ai {
+
+namespace {
+
+constexpr uint32_t FULL_ROW = (1u << Grid::width()) - 1;
+
+// A row with a filled wall on either side: bit 0 and bit WIDTH + 1 are the walls, the columns sit in between.
+constexpr uint32_t WALLS = 1u | 1u << (Grid::width() + 1);
+
+// The transitions between the WIDTH + 2 cells of a walled row.
+constexpr uint32_t TRANSITIONS = (1u << (Grid::width() + 1)) - 1;
+
+// Wells and bumpiness follow from the column heights.
+void finish(BoardFeatures& features)
+{
+	features.aggregateHeight = 0;
+	features.bumpiness       = 0;
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		const int height = features.columnHeights[column];
+		const int left   = column > 0 ? features.columnHeights[column - 1] : Grid::height();
+		const int right  = column + 1 < Grid::width() ? features.columnHeights[column + 1] : Grid::height();
+
+		features.aggregateHeight += height;
+		features.wellDepths[column] = static_cast<uint8_t>(std::max(0, std::min(left, right) - height));
+		if (column + 1 < Grid::width())
+		{
+			features.bumpiness += std::abs(height - right);
+		}
+	}
+}
+
+#ifdef HAVE_AVX2_KERNELS
+
+constexpr size_t LANES         = 16;
+constexpr int    HEIGHT_PLANES = 5; // bits of a column height
+
+static_assert(Grid::height() < 1 << HEIGHT_PLANES, "a column height must fit in the height planes");
+
+// Bit counts of the bytes of x. Each byte holds at most 8, so up to 31 of these can be added up before a byte overflows.
+AVX2_KERNEL inline __m256i popcount_bytes(__m256i x)
+{
+	const auto table  = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const auto nibble = _mm256_set1_epi8(0x0f);
+	return _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, nibble)),
+	                       _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+}
+
+// Adds the two byte counts of each 16 bit lane.
+AVX2_KERNEL inline __m256i fold_bytes(__m256i x)
+{
+	return _mm256_add_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0xff)), _mm256_srli_epi16(x, 8));
+}
+
+// One grid per 16 bit lane. The rows are walked top down, and the column heights are counted in bit-sliced form: plane k
+// holds bit k of the height of every column at once, and each row adds one for every column that has a mino at or above
+// it. Holes are the aggregate height minus the minos.
+AVX2_KERNEL void extract_avx2(const Grid::Bitboard* grids, BoardFeatures* features)
+{
+	alignas(32) uint16_t rows[Grid::height()][LANES];
+	for (size_t lane = 0; lane < LANES; ++lane)
+	{
+		for (int row = 0; row < Grid::height(); ++row)
+		{
+			rows[row][lane] = grids[lane][row];
+		}
+	}
+
+	const auto zero        = _mm256_setzero_si256();
+	const auto full        = _mm256_set1_epi16(FULL_ROW);
+	const auto walls       = _mm256_set1_epi16(WALLS);
+	const auto transitions = _mm256_set1_epi16(TRANSITIONS);
+
+	__m256i planes[HEIGHT_PLANES];
+	std::fill(std::begin(planes), std::end(planes), zero);
+
+	auto seen              = zero;
+	auto previous          = zero;
+	auto minos             = zero;
+	auto rowTransitions    = zero;
+	auto columnTransitions = zero;
+	for (int row = 0; row < Grid::height(); ++row)
+	{
+		const auto bits = _mm256_load_si256(reinterpret_cast<const __m256i*>(rows[row]));
+		seen            = _mm256_or_si256(seen, bits);
+
+		auto carry = seen;
+		for (auto& plane : planes)
+		{
+			const auto next = _mm256_and_si256(plane, carry);
+			plane           = _mm256_xor_si256(plane, carry);
+			carry           = next;
+		}
+
+		// Rows above the highest mino have no transitions but the two at the walls, which do not count.
+		const auto walled = _mm256_or_si256(_mm256_slli_epi16(bits, 1), walls);
+		auto       change = _mm256_and_si256(_mm256_xor_si256(walled, _mm256_srli_epi16(walled, 1)), transitions);
+		change            = _mm256_andnot_si256(_mm256_cmpeq_epi16(seen, zero), change);
+
+		minos             = _mm256_add_epi8(minos, popcount_bytes(bits));
+		rowTransitions    = _mm256_add_epi8(rowTransitions, popcount_bytes(change));
+		columnTransitions = _mm256_add_epi8(columnTransitions, popcount_bytes(_mm256_xor_si256(previous, bits)));
+		previous          = bits;
+	}
+	columnTransitions = _mm256_add_epi8(columnTransitions, popcount_bytes(_mm256_xor_si256(previous, full)));
+
+	__m256i heights[Grid::width()];
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		const auto shift = _mm_cvtsi32_si128(column);
+		heights[column]  = zero;
+		for (int k = 0; k < HEIGHT_PLANES; ++k)
+		{
+			const auto bit  = _mm256_and_si256(_mm256_srl_epi16(planes[k], shift), _mm256_set1_epi16(1));
+			heights[column] = _mm256_or_si256(heights[column], _mm256_slli_epi16(bit, k));
+		}
+	}
+
+	alignas(32) uint16_t columns[2][Grid::width()][LANES];
+	auto                 aggregate = zero;
+	auto                 bumpiness = zero;
+	const auto           wall      = _mm256_set1_epi16(Grid::height());
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		const auto left  = column > 0 ? heights[column - 1] : wall;
+		const auto right = column + 1 < Grid::width() ? heights[column + 1] : wall;
+		const auto well  = _mm256_max_epi16(_mm256_sub_epi16(_mm256_min_epi16(left, right), heights[column]), zero);
+
+		aggregate = _mm256_add_epi16(aggregate, heights[column]);
+		if (column + 1 < Grid::width())
+		{
+			bumpiness = _mm256_add_epi16(bumpiness, _mm256_abs_epi16(_mm256_sub_epi16(heights[column], right)));
+		}
+		_mm256_store_si256(reinterpret_cast<__m256i*>(columns[0][column]), heights[column]);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(columns[1][column]), well);
+	}
+
+	alignas(32) uint16_t totals[5][LANES];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(totals[0]), aggregate);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(totals[1]), _mm256_sub_epi16(aggregate, fold_bytes(minos)));
+	_mm256_store_si256(reinterpret_cast<__m256i*>(totals[2]), bumpiness);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(totals[3]), fold_bytes(rowTransitions));
+	_mm256_store_si256(reinterpret_cast<__m256i*>(totals[4]), fold_bytes(columnTransitions));
+
+	for (size_t lane = 0; lane < LANES; ++lane)
+	{
+		auto& f = features[lane];
+		for (int column = 0; column < Grid::width(); ++column)
+		{
+			f.columnHeights[column] = static_cast<uint8_t>(columns[0][column][lane]);
+			f.wellDepths[column]    = static_cast<uint8_t>(columns[1][column][lane]);
+		}
+		f.aggregateHeight   = totals[0][lane];
+		f.holes             = totals[1][lane];
+		f.bumpiness         = totals[2][lane];
+		f.rowTransitions    = totals[3][lane];
+		f.columnTransitions = totals[4][lane];
+	}
+}
+
+#endif
+
+} // namespace
+
+BoardFeatures BoardFeatures::of(const Grid::Bitboard& grid)
+{
+	BoardFeatures features{};
+
+	uint32_t seen{}, previous{};
+	int      minos{};
+	for (const uint32_t bits : grid)
+	{
+		seen |= bits;
+		for (auto columns = seen; columns; columns &= columns - 1)
+		{
+			++features.columnHeights[countr_zero(columns)];
+		}
+
+		if (seen)
+		{
+			const auto walled = bits << 1 | WALLS;
+			features.rowTransitions += popcount((walled ^ walled >> 1) & TRANSITIONS);
+		}
+		features.columnTransitions += popcount(previous ^ bits);
+		minos += popcount(bits);
+		previous = bits;
+	}
+	features.columnTransitions += popcount(previous ^ FULL_ROW);
+
+	finish(features);
+	features.holes = static_cast<uint16_t>(features.aggregateHeight - minos);
+	return features;
+}
+
+void BoardFeatures::extract(const Grid::Bitboard* grids, size_t count, BoardFeatures* features, bool vectorize)
+{
+	size_t done{};
+#ifdef HAVE_AVX2_KERNELS
+	if (vectorize && cpu_has_avx2())
+	{
+		for (; done + LANES <= count; done += LANES)
+		{
+			extract_avx2(grids + done, features + done);
+		}
+	}
+#else
+	(void)vectorize;
+#endif
+	for (; done < count; ++done)
+	{
+		features[done] = of(grids[done]);
+	}
+}
+
+BoardFeatures BoardFeatures::reference(const Grid& grid)
+{
+	BoardFeatures features{};
+
+	int minos{}, top = Grid::height();
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		auto below = true; // the floor
+		for (int row = Grid::height() - 1; row >= 0; --row)
+		{
+			const auto filled = grid.cell(row, column).has_value();
+			if (filled)
+			{
+				features.columnHeights[column] = static_cast<uint8_t>(Grid::height() - row);
+				top                            = std::min(top, row);
+				++minos;
+			}
+			features.columnTransitions += filled != below;
+			below = filled;
+		}
+		features.columnTransitions += below;
+	}
+
+	for (int row = top; row < Grid::height(); ++row)
+	{
+		auto left = true; // the wall
+		for (int column = 0; column < Grid::width(); ++column)
+		{
+			const auto filled = grid.cell(row, column).has_value();
+			features.rowTransitions += filled != left;
+			left = filled;
+		}
+		features.rowTransitions += !left;
+	}
+
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		const int height = features.columnHeights[column];
+		const int left   = column > 0 ? features.columnHeights[column - 1] : Grid::height();
+		const int right  = column + 1 < Grid::width() ? features.columnHeights[column + 1] : Grid::height();
+
+		features.aggregateHeight += height;
+		features.wellDepths[column] = static_cast<uint8_t>(std::max(0, std::min(left, right) - height));
+		if (column + 1 < Grid::width())
+		{
+			features.bumpiness += std::abs(height - right);
+		}
+	}
+	features.holes = static_cast<uint16_t>(features.aggregateHeight - minos);
+	return features;
+}
+
+bool BoardFeatures::equals(const BoardFeatures& other) const
+{
+	return this->columnHeights == other.columnHeights && this->wellDepths == other.wellDepths
+	    && this->aggregateHeight == other.aggregateHeight && this->holes == other.holes && this->bumpiness == other.bumpiness
+	    && this->rowTransitions == other.rowTransitions && this->columnTransitions == other.columnTransitions;
+}
+
+} // namespace ai
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "grid.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai {
+
+// The standard board features, for scoring and for datasets. extract() computes them for many grids in one call, 16 grids
+// at a time in the lanes of AVX2 registers when the processor has it.
+struct BoardFeatures final
+{
+	std::array<uint8_t, Grid::width()> columnHeights;
+	std::array<uint8_t, Grid::width()> wellDepths; // how far a column is below both neighbours, counting the walls as high
+
+	uint16_t aggregateHeight;
+	uint16_t holes;             // empty cells with a mino above them
+	uint16_t bumpiness;         // sum of the height differences of neighbouring columns
+	uint16_t rowTransitions;    // filled-empty changes along the rows up to the highest mino, counting the walls as filled
+	uint16_t columnTransitions; // filled-empty changes up the columns, counting the floor as filled
+
+	static BoardFeatures of(const Grid::Bitboard& grid);
+
+	// Writes the features of count grids to features. With vectorize unset, or on a processor without AVX2, the grids
+	// are done one by one with of().
+	static void extract(const Grid::Bitboard* grids, size_t count, BoardFeatures* features, bool vectorize = true);
+
+	// The features the plain way, cell by cell through Grid::cell(), to check of() and extract() against.
+	static BoardFeatures reference(const Grid& grid);
+
+	bool equals(const BoardFeatures& other) const;
+};
+
+} // namespace ai
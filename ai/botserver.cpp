@@ -0,0 +1,54 @@
+#include "botserver.h"
+#include "botprotocol.h"
+#include "gamestate.h"
+
+namespace ai {
+
+BotServer::BotServer(std::unique_ptr<ISearch> search, std::string name)
+    : search_{ std::move(search) }
+    , name_{ std::move(name) }
+{
+}
+
+void BotServer::run(int in, int out)
+{
+	BotChannel channel{ in, out };
+
+	BotMessage info{ BotMessage::Type::INFO };
+	info.version = BotMessage::VERSION;
+	info.name    = this->name_;
+	channel.send(info);
+	channel.flush();
+
+	BotMessage request{ BotMessage::Type::QUIT };
+	while (channel.receive(request) && request.type != BotMessage::Type::QUIT)
+	{
+		if (request.type == BotMessage::Type::SUGGEST)
+		{
+			BotMessage answer{ BotMessage::Type::SUGGESTION };
+			answer.id = request.id;
+
+			const auto state = request.state.gameState();
+			if (state.board->playingTetromino())
+			{
+				if (const auto placement = this->search_->choose(state))
+				{
+					answer.moves.push_back(BotMove{ BotMove::Kind::PLACEMENT, placement->rotation, placement->row, placement->column, {} });
+				}
+			}
+			channel.send(answer);
+		}
+		else if (request.type == BotMessage::Type::PING)
+		{
+			channel.send(BotMessage{ BotMessage::Type::PONG, request.id });
+		}
+
+		if (!channel.buffered())
+		{
+			channel.flush();
+		}
+	}
+	channel.flush();
+}
+
+} // namespace ai
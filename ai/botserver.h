@@ -0,0 +1,26 @@
+#pragma once
+
+#include "isearch.h"
+
+#include <memory>
+#include <string>
+
+namespace ai {
+
+// The bot side of the protocol of botprotocol.h: answers every SUGGEST with the placement a search chooses for it. The
+// requests are answered in the order they arrive, and the answers only go out when no further request is waiting, so a
+// pipelined burst of requests is answered with one write.
+class BotServer final
+{
+	std::unique_ptr<ISearch> search_;
+	std::string              name_;
+
+public:
+	BotServer(std::unique_ptr<ISearch> search, std::string name);
+
+	// Reads the requests of the game from in and writes the answers to out, until the game sends QUIT or closes its end.
+	// Throws std::runtime_error when the game breaks the protocol.
+	void run(int in, int out);
+};
+
+} // namespace ai
@@ -0,0 +1,391 @@
+#include "cmaes.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace ai {
+
+namespace {
+
+constexpr auto FORMAT = "cmaes 1";
+constexpr auto PI     = 3.14159265358979323846;
+
+// Uniform in (0, 1].
+double uniform(Xoshiro256& random)
+{
+	return static_cast<double>((random() >> 11) + 1) * 0x1.0p-53;
+}
+
+// Box-Muller, one of the pair at a time, so that the sequence only depends on the generator state.
+double gaussian(Xoshiro256& random)
+{
+	const auto radius = std::sqrt(-2.0 * std::log(uniform(random)));
+	return radius * std::cos(2.0 * PI * uniform(random));
+}
+
+// Eigenvalues and eigenvectors (in the columns of vectors) of a symmetric matrix, by cyclic Jacobi rotations. Plenty fast
+// and accurate for the handful of dimensions the strategy is used for.
+void eigen(std::vector<std::vector<double>> a, std::vector<std::vector<double>>& vectors, std::vector<double>& values)
+{
+	const auto n = a.size();
+	vectors.assign(n, std::vector<double>(n, 0.0));
+	for (size_t i = 0; i < n; ++i)
+	{
+		vectors[i][i] = 1.0;
+	}
+
+	for (int sweep = 0; sweep < 100; ++sweep)
+	{
+		double off{};
+		for (size_t p = 0; p < n; ++p)
+		{
+			for (size_t q = p + 1; q < n; ++q)
+			{
+				off += a[p][q] * a[p][q];
+			}
+		}
+		if (off < 1e-30)
+		{
+			break;
+		}
+
+		for (size_t p = 0; p < n; ++p)
+		{
+			for (size_t q = p + 1; q < n; ++q)
+			{
+				if (a[p][q] == 0.0)
+				{
+					continue;
+				}
+				const auto theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+				const auto t     = (theta < 0.0 ? -1.0 : 1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+				const auto c     = 1.0 / std::sqrt(t * t + 1.0);
+				const auto s     = t * c;
+				for (size_t k = 0; k < n; ++k)
+				{
+					const auto kp = a[k][p];
+					const auto kq = a[k][q];
+					a[k][p]       = c * kp - s * kq;
+					a[k][q]       = s * kp + c * kq;
+				}
+				for (size_t k = 0; k < n; ++k)
+				{
+					const auto pk = a[p][k];
+					const auto qk = a[q][k];
+					a[p][k]       = c * pk - s * qk;
+					a[q][k]       = s * pk + c * qk;
+				}
+				for (size_t k = 0; k < n; ++k)
+				{
+					const auto kp = vectors[k][p];
+					const auto kq = vectors[k][q];
+					vectors[k][p] = c * kp - s * kq;
+					vectors[k][q] = s * kp + c * kq;
+				}
+			}
+		}
+	}
+
+	values.resize(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		values[i] = a[i][i];
+	}
+}
+
+void write(std::ostream& out, const char* name, const std::vector<double>& values)
+{
+	out << name;
+	for (const auto value : values)
+	{
+		out << ' ' << value;
+	}
+	out << '\n';
+}
+
+void read(std::istream& in, const char* name, std::vector<double>& values)
+{
+	std::string word{};
+	in >> word;
+	if (word != name)
+	{
+		throw std::runtime_error{ std::string{ "CMA-ES state: expected " } + name };
+	}
+	for (auto& value : values)
+	{
+		in >> value;
+	}
+}
+
+} // namespace
+
+void CmaEs::setParameters()
+{
+	const auto n = static_cast<double>(this->n_);
+
+	this->mu_ = this->lambda_ / 2;
+	this->weights_.resize(this->mu_);
+	for (size_t i = 0; i < this->mu_; ++i)
+	{
+		this->weights_[i] = std::log(this->mu_ + 0.5) - std::log(i + 1.0);
+	}
+	const auto sum = std::accumulate(this->weights_.begin(), this->weights_.end(), 0.0);
+	double     squares{};
+	for (auto& weight : this->weights_)
+	{
+		weight /= sum;
+		squares += weight * weight;
+	}
+	this->mueff_ = 1.0 / squares;
+
+	this->cc_    = (4.0 + this->mueff_ / n) / (n + 4.0 + 2.0 * this->mueff_ / n);
+	this->cs_    = (this->mueff_ + 2.0) / (n + this->mueff_ + 5.0);
+	this->c1_    = 2.0 / ((n + 1.3) * (n + 1.3) + this->mueff_);
+	this->cmu_   = std::min(1.0 - this->c1_, 2.0 * (this->mueff_ - 2.0 + 1.0 / this->mueff_) / ((n + 2.0) * (n + 2.0) + this->mueff_));
+	this->damps_ = 1.0 + 2.0 * std::max(0.0, std::sqrt((this->mueff_ - 1.0) / (n + 1.0)) - 1.0) + this->cs_;
+	this->chiN_  = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+}
+
+// C = B diag(D)^2 B^T
+void CmaEs::decompose()
+{
+	for (size_t i = 0; i < this->n_; ++i)
+	{
+		for (size_t j = 0; j < i; ++j)
+		{
+			this->c_[j][i] = this->c_[i][j];
+		}
+	}
+	eigen(this->c_, this->b_, this->d_);
+	for (auto& d : this->d_)
+	{
+		d = std::sqrt(std::max(d, 1e-20));
+	}
+}
+
+CmaEs::CmaEs(const Vector& mean, double sigma, size_t lambda, uint64_t seed)
+    : n_{ mean.size() }
+    , lambda_{ lambda ? lambda : 4 + static_cast<size_t>(3.0 * std::log(static_cast<double>(mean.size()))) }
+    , mu_{}
+    , weights_{}
+    , mueff_{}
+    , cc_{}
+    , cs_{}
+    , c1_{}
+    , cmu_{}
+    , damps_{}
+    , chiN_{}
+    , mean_{ mean }
+    , sigma_{ sigma }
+    , c_(mean.size(), Vector(mean.size(), 0.0))
+    , pc_(mean.size(), 0.0)
+    , ps_(mean.size(), 0.0)
+    , b_{}
+    , d_{}
+    , random_{ seed }
+    , generation_{}
+    , candidates_{}
+{
+	if (this->n_ == 0 || this->lambda_ < 2 || !(sigma > 0.0))
+	{
+		throw std::invalid_argument{ "CMA-ES needs a variable, a population of at least 2 and a positive sigma" };
+	}
+	for (size_t i = 0; i < this->n_; ++i)
+	{
+		this->c_[i][i] = 1.0;
+	}
+	this->setParameters();
+}
+
+size_t CmaEs::lambda() const
+{
+	return this->lambda_;
+}
+
+uint64_t CmaEs::generation() const
+{
+	return this->generation_;
+}
+
+double CmaEs::sigma() const
+{
+	return this->sigma_;
+}
+
+const CmaEs::Vector& CmaEs::mean() const
+{
+	return this->mean_;
+}
+
+const std::vector<CmaEs::Vector>& CmaEs::ask()
+{
+	this->decompose();
+
+	this->candidates_.assign(this->lambda_, this->mean_);
+	Vector z(this->n_);
+	for (auto& x : this->candidates_)
+	{
+		for (auto& value : z)
+		{
+			value = gaussian(this->random_);
+		}
+		for (size_t i = 0; i < this->n_; ++i)
+		{
+			for (size_t j = 0; j < this->n_; ++j)
+			{
+				x[i] += this->sigma_ * this->b_[i][j] * this->d_[j] * z[j];
+			}
+		}
+	}
+	return this->candidates_;
+}
+
+void CmaEs::tell(const std::vector<double>& values)
+{
+	assert(values.size() == this->candidates_.size());
+	const auto n = this->n_;
+
+	std::vector<size_t> order(values.size());
+	std::iota(order.begin(), order.end(), size_t{ 0 });
+	std::stable_sort(order.begin(), order.end(), [&values](size_t a, size_t b) { return values[a] < values[b]; });
+
+	// The new mean is the weighted mean of the best mu candidates, and y the step it took in units of sigma.
+	const auto old = this->mean_;
+	std::fill(this->mean_.begin(), this->mean_.end(), 0.0);
+	for (size_t k = 0; k < this->mu_; ++k)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			this->mean_[i] += this->weights_[k] * this->candidates_[order[k]][i];
+		}
+	}
+	Vector y(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		y[i] = (this->mean_[i] - old[i]) / this->sigma_;
+	}
+
+	// The evolution path of sigma follows C^-1/2 y = B diag(D)^-1 B^T y.
+	Vector by(n, 0.0);
+	for (size_t j = 0; j < n; ++j)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			by[j] += this->b_[i][j] * y[i];
+		}
+		by[j] /= this->d_[j];
+	}
+	const auto ps = std::sqrt(this->cs_ * (2.0 - this->cs_) * this->mueff_);
+	for (size_t i = 0; i < n; ++i)
+	{
+		double whitened{};
+		for (size_t j = 0; j < n; ++j)
+		{
+			whitened += this->b_[i][j] * by[j];
+		}
+		this->ps_[i] = (1.0 - this->cs_) * this->ps_[i] + ps * whitened;
+	}
+
+	const auto psNorm = std::sqrt(std::inner_product(this->ps_.begin(), this->ps_.end(), this->ps_.begin(), 0.0));
+	const auto decay  = 1.0 - std::pow(1.0 - this->cs_, 2.0 * (this->generation_ + 1));
+	const auto hsig   = psNorm / std::sqrt(decay) / this->chiN_ < 1.4 + 2.0 / (n + 1.0) ? 1.0 : 0.0;
+
+	const auto pc = std::sqrt(this->cc_ * (2.0 - this->cc_) * this->mueff_);
+	for (size_t i = 0; i < n; ++i)
+	{
+		this->pc_[i] = (1.0 - this->cc_) * this->pc_[i] + hsig * pc * y[i];
+	}
+
+	// Rank one update from the evolution path, rank mu update from the steps of the selected candidates.
+	const auto keep = 1.0 - this->c1_ - this->cmu_ + (1.0 - hsig) * this->c1_ * this->cc_ * (2.0 - this->cc_);
+	for (size_t i = 0; i < n; ++i)
+	{
+		for (size_t j = 0; j <= i; ++j)
+		{
+			double rankMu{};
+			for (size_t k = 0; k < this->mu_; ++k)
+			{
+				const auto& x = this->candidates_[order[k]];
+				rankMu += this->weights_[k] * (x[i] - old[i]) * (x[j] - old[j]);
+			}
+			rankMu /= this->sigma_ * this->sigma_;
+			this->c_[i][j] = keep * this->c_[i][j] + this->c1_ * this->pc_[i] * this->pc_[j] + this->cmu_ * rankMu;
+		}
+	}
+
+	this->sigma_ *= std::exp((this->cs_ / this->damps_) * (psNorm / this->chiN_ - 1.0));
+	++this->generation_;
+}
+
+void CmaEs::save(std::ostream& out) const
+{
+	const auto precision = out.precision(17);
+	out << FORMAT << '\n';
+	out << "size " << this->n_ << ' ' << this->lambda_ << '\n';
+	out << "generation " << this->generation_ << '\n';
+	out << "sigma " << this->sigma_ << '\n';
+	write(out, "mean", this->mean_);
+	write(out, "pc", this->pc_);
+	write(out, "ps", this->ps_);
+	for (const auto& row : this->c_)
+	{
+		write(out, "c", row);
+	}
+	out << "random";
+	for (const auto word : this->random_.state())
+	{
+		out << ' ' << word;
+	}
+	out << '\n';
+	out.precision(precision);
+}
+
+CmaEs CmaEs::load(std::istream& in)
+{
+	std::string format{};
+	std::getline(in, format);
+
+	std::string size{}, generation{}, sigma{};
+	size_t      n{}, lambda{};
+	in >> size >> n >> lambda;
+	if (format != FORMAT || size != "size" || !in || n == 0 || lambda < 2)
+	{
+		throw std::runtime_error{ "not a CMA-ES state" };
+	}
+
+	CmaEs cmaes{ Vector(n, 0.0), 1.0, lambda, 0 };
+	in >> generation >> cmaes.generation_ >> sigma >> cmaes.sigma_;
+	if (generation != "generation" || sigma != "sigma")
+	{
+		throw std::runtime_error{ "CMA-ES state: expected generation and sigma" };
+	}
+	read(in, "mean", cmaes.mean_);
+	read(in, "pc", cmaes.pc_);
+	read(in, "ps", cmaes.ps_);
+	for (auto& row : cmaes.c_)
+	{
+		read(in, "c", row);
+	}
+
+	std::string       random{};
+	Xoshiro256::State state{};
+	in >> random;
+	for (auto& word : state)
+	{
+		in >> word;
+	}
+	if (random != "random" || !in)
+	{
+		throw std::runtime_error{ "truncated CMA-ES state" };
+	}
+	cmaes.random_.setState(state);
+	return cmaes;
+}
+
+} // namespace ai
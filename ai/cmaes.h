@@ -0,0 +1,65 @@
+#pragma once
+
+#include "xoshiro256.h"
+
+#include <iosfwd>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai {
+
+// The covariance matrix adaptation evolution strategy (Hansen, "The CMA Evolution Strategy: A Tutorial"), minimizing a
+// function of a few variables that can only be sampled, such as the outcome of games. Each generation, ask() draws the
+// candidates from a multivariate normal distribution and tell() moves the distribution towards the better ones.
+//
+// The state, including that of the random generator, is saved and loaded as text, so a run can stop after any
+// generation and resume with the same candidates it would have drawn.
+class CmaEs final
+{
+public:
+	using Vector = std::vector<double>;
+
+private:
+	using Matrix = std::vector<Vector>;
+
+	size_t     n_;
+	size_t     lambda_;
+	size_t     mu_;
+	Vector     weights_;
+	double     mueff_, cc_, cs_, c1_, cmu_, damps_, chiN_;
+	Vector     mean_;
+	double     sigma_;
+	Matrix     c_;
+	Vector     pc_, ps_;
+	Matrix     b_;
+	Vector     d_;
+	Xoshiro256 random_;
+	uint64_t   generation_;
+
+	std::vector<Vector> candidates_;
+
+	void setParameters();
+	void decompose();
+
+public:
+	// lambda 0 picks the default population size for the dimension, 4 + 3 ln n. Throws std::invalid_argument when the mean
+	// is empty, lambda is 1 or sigma is not positive.
+	CmaEs(const Vector& mean, double sigma, size_t lambda, uint64_t seed);
+
+	size_t        lambda() const;
+	uint64_t      generation() const;
+	double        sigma() const;
+	const Vector& mean() const;
+
+	// The candidates of the next generation.
+	const std::vector<Vector>& ask();
+
+	// The values of the candidates ask() returned last, lower is better.
+	void tell(const std::vector<double>& values);
+
+	void         save(std::ostream& out) const;
+	static CmaEs load(std::istream& in);
+};
+
+} // namespace ai
@@ -0,0 +1,35 @@
+#include "features.h"
+#include "grid.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace ai {
+
+Features Features::of(const Grid& grid, int linesCleared)
+{
+	Features features{};
+	features.holes        = grid.holes();
+	features.linesCleared = linesCleared;
+
+	auto left   = Grid::height();
+	auto height = grid.columnHeight(0);
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		const auto right = column + 1 < Grid::width() ? grid.columnHeight(column + 1) : Grid::height();
+
+		features.aggregateHeight += height;
+		features.wells += std::max(0, std::min(left, right) - height);
+		if (column + 1 < Grid::width())
+		{
+			features.bumpiness += std::abs(height - right);
+		}
+
+		left   = height;
+		height = right;
+	}
+
+	return features;
+}
+
+} // namespace ai
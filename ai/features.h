@@ -0,0 +1,19 @@
+#pragma once
+
+class Grid;
+
+namespace ai {
+
+// The board properties the heuristic evaluator weighs.
+struct Features final
+{
+	int aggregateHeight; // sum of the column heights
+	int holes;           // empty cells with a mino above them
+	int bumpiness;       // sum of the height differences of neighbouring columns
+	int wells;           // sum of the depths of columns lower than both neighbours, counting the walls as high
+	int linesCleared;
+
+	static Features of(const Grid& grid, int linesCleared);
+};
+
+} // namespace ai
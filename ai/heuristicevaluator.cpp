@@ -0,0 +1,124 @@
+#include "heuristicevaluator.h"
+
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace ai {
+
+const HeuristicEvaluator::Weights::Fields& HeuristicEvaluator::Weights::fields()
+{
+	static const Fields fields{ { { "aggregateHeight", &Weights::aggregateHeight },
+		                          { "holes", &Weights::holes },
+		                          { "bumpiness", &Weights::bumpiness },
+		                          { "wells", &Weights::wells },
+		                          { "linesCleared", &Weights::linesCleared } } };
+	return fields;
+}
+
+HeuristicEvaluator::Weights HeuristicEvaluator::Weights::load(const std::string& path)
+{
+	std::ifstream in{ path };
+	if (!in)
+	{
+		throw std::runtime_error{ "cannot read weights file: " + path };
+	}
+
+	Weights     weights{};
+	std::string name{};
+	double      value{};
+	while (in >> name >> value)
+	{
+		auto known = false;
+		for (const auto& field : fields())
+		{
+			if (name == field.first)
+			{
+				weights.*field.second = value;
+				known                 = true;
+			}
+		}
+		if (!known)
+		{
+			throw std::runtime_error{ "unknown weight " + name + " in " + path };
+		}
+	}
+	if (!in.eof())
+	{
+		throw std::runtime_error{ "malformed weights file: " + path };
+	}
+	return weights;
+}
+
+HeuristicEvaluator::Weights HeuristicEvaluator::Weights::startup()
+{
+	if (!std::ifstream{ DEFAULT_FILE })
+	{
+		return Weights{};
+	}
+
+	try
+	{
+		auto weights = load(DEFAULT_FILE);
+		spdlog::info("heuristic weights loaded from {}", DEFAULT_FILE);
+		return weights;
+	}
+	catch (const std::runtime_error& e)
+	{
+		spdlog::error("{}, using the default heuristic weights", e.what());
+		return Weights{};
+	}
+}
+
+void HeuristicEvaluator::Weights::save(const std::string& path) const
+{
+	std::ofstream out{ path, std::ios::trunc };
+	out.precision(std::numeric_limits<double>::max_digits10);
+	for (const auto& field : fields())
+	{
+		out << field.first << ' ' << this->*field.second << '\n';
+	}
+
+	out.flush();
+	if (!out)
+	{
+		throw std::runtime_error{ "cannot write weights file: " + path };
+	}
+}
+
+HeuristicEvaluator::HeuristicEvaluator()
+    : weights_{}
+{
+}
+
+HeuristicEvaluator::HeuristicEvaluator(const Weights& weights)
+    : weights_{ weights }
+{
+}
+
+const HeuristicEvaluator::Weights& HeuristicEvaluator::weights() const
+{
+	return this->weights_;
+}
+
+double HeuristicEvaluator::evaluate(const Features& features) const
+{
+	const auto& w = this->weights_;
+	return w.aggregateHeight * features.aggregateHeight + w.holes * features.holes + w.bumpiness * features.bumpiness +
+	       w.wells * features.wells + w.linesCleared * features.linesCleared;
+}
+
+double HeuristicEvaluator::evaluate(const Grid& grid, int linesCleared) const
+{
+	return this->evaluate(Features::of(grid, linesCleared));
+}
+
+bool HeuristicEvaluator::symmetric() const
+{
+	// Every feature is a sum over columns or neighbouring column pairs, which mirroring only reorders.
+	return true;
+}
+
+} // namespace ai
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ievaluator.h"
+#include "features.h"
+
+#include <array>
+#include <string>
+#include <utility>
+
+namespace ai {
+
+// A weighted sum of the board features.
+class HeuristicEvaluator final : public IEvaluator
+{
+public:
+	struct Weights final
+	{
+		double aggregateHeight = -0.510066;
+		double holes           = -0.35663;
+		double bumpiness       = -0.184483;
+		double wells           = -0.05;
+		double linesCleared    = 0.760666;
+
+		// The file `tetris tune` writes, which the players load at startup when it is in the working directory.
+		static constexpr auto DEFAULT_FILE = "heuristic.weights";
+
+		// Each weight with its name in a weights file.
+		using Fields = std::array<std::pair<const char*, double Weights::*>, 5>;
+		static const Fields& fields();
+
+		// A text file of "name value" lines, one per weight. Weights missing from the file keep their defaults. Both throw
+		// std::runtime_error when the file cannot be read or written.
+		static Weights load(const std::string& path);
+		void           save(const std::string& path) const;
+
+		// The weights in DEFAULT_FILE when there is one, else the defaults. Logs rather than throws when the file is bad.
+		static Weights startup();
+	};
+
+private:
+	Weights weights_;
+
+public:
+	HeuristicEvaluator();
+	explicit HeuristicEvaluator(const Weights& weights);
+
+	const Weights& weights() const;
+
+	double evaluate(const Features& features) const;
+	double evaluate(const Grid& grid, int linesCleared) const override;
+	bool   symmetric() const override;
+};
+
+} // namespace ai
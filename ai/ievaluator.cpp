@@ -0,0 +1,22 @@
+#include "ievaluator.h"
+
+namespace ai {
+
+IEvaluator::~IEvaluator() noexcept
+{
+}
+
+void IEvaluator::evaluateBatch(const Grid* const* grids, const int* linesCleared, double* scores, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		scores[i] = this->evaluate(*grids[i], linesCleared[i]);
+	}
+}
+
+bool IEvaluator::symmetric() const
+{
+	return false;
+}
+
+} // namespace ai
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+class Grid;
+
+namespace ai {
+
+// Scores a grid for the search: higher is better. Only the relative order of scores matters.
+class IEvaluator
+{
+public:
+	virtual ~IEvaluator() noexcept;
+
+	// linesCleared counts the lines cleared on the way from the position the search started at to this grid.
+	virtual double evaluate(const Grid& grid, int linesCleared) const = 0;
+
+	// Scores count grids at once. Evaluators that vectorize override it, by default the grids are scored one by one.
+	virtual void evaluateBatch(const Grid* const* grids, const int* linesCleared, double* scores, size_t count) const;
+
+	// Whether a grid and its left-right mirror image always get the same score, so that they may share cached scores.
+	virtual bool symmetric() const;
+};
+
+} // namespace ai
@@ -0,0 +1,14 @@
+#include "isearch.h"
+
+namespace ai {
+
+ISearch::~ISearch() noexcept
+{
+}
+
+uint64_t ISearch::rollouts() const
+{
+	return 0;
+}
+
+} // namespace ai
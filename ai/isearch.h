@@ -0,0 +1,26 @@
+#pragma once
+
+#include "placement.h"
+
+#include <optional>
+#include <cstdint>
+
+struct GameState;
+
+namespace ai {
+
+// Decides where the playing tetromino goes.
+class ISearch
+{
+public:
+	virtual ~ISearch() noexcept;
+
+	// A placement of the playing tetromino, or nullopt when there is none. The search may look at the grid, the playing and
+	// next tetromino and which tetrominoes are left in the bag, but not at the order the dealer will deal them in.
+	virtual std::optional<Placement> choose(const GameState& state) = 0;
+
+	// Number of games played out so far, for searches that evaluate placements by playing them out.
+	virtual uint64_t rollouts() const;
+};
+
+} // namespace ai
@@ -0,0 +1,83 @@
+#include "lockstepplayer.h"
+#include "ievaluator.h"
+#include "simulation.h"
+#include "board.h"
+#include "gridposition.h"
+#include "tetromino.h"
+
+namespace ai {
+
+LockstepPlayer::LockstepPlayer(const IEvaluator& evaluator)
+    : evaluator_{ evaluator }
+{
+}
+
+size_t LockstepPlayer::round(Simulation* simulations, size_t count)
+{
+	this->moves_.clear();
+	this->grids_.clear();
+	this->linesCleared_.clear();
+	for (size_t game = 0; game < count; ++game)
+	{
+		const auto& board            = simulations[game].board();
+		const auto  playingTetromino = board.playingTetromino();
+		if (board.gameOver() || !playingTetromino)
+		{
+			continue;
+		}
+
+		const auto type = playingTetromino->tetromino().type();
+		for (const auto& placement : this->generator_.generate(board.grid(), type))
+		{
+			auto grid = board.grid();
+			grid.place(Tetromino{ type, placement.rotation }, GridPosition{ placement.row, placement.column });
+			this->linesCleared_.push_back(grid.clearFullLines());
+			this->grids_.push_back(grid);
+			this->moves_.emplace_back(game, placement);
+		}
+	}
+
+	// The grids are all in place now, so their addresses hold.
+	this->batch_.clear();
+	for (const auto& grid : this->grids_)
+	{
+		this->batch_.push_back(&grid);
+	}
+	this->scores_.resize(this->batch_.size());
+
+	const auto started = std::chrono::steady_clock::now();
+	this->evaluator_.evaluateBatch(this->batch_.data(), this->linesCleared_.data(), this->scores_.data(), this->batch_.size());
+	this->evaluating_ += std::chrono::steady_clock::now() - started;
+	this->evaluations_ += this->batch_.size();
+
+	size_t placed{};
+	for (size_t first = 0; first < this->moves_.size(); ++placed)
+	{
+		auto best = first;
+		auto last = first;
+		for (; last < this->moves_.size() && this->moves_[last].first == this->moves_[first].first; ++last)
+		{
+			if (this->scores_[last] > this->scores_[best])
+			{
+				best = last;
+			}
+		}
+
+		const auto& placement = this->moves_[best].second;
+		simulations[this->moves_[best].first].lockAt(placement.rotation, GridPosition{ placement.row, placement.column });
+		first = last;
+	}
+	return placed;
+}
+
+uint64_t LockstepPlayer::evaluations() const
+{
+	return this->evaluations_;
+}
+
+double LockstepPlayer::evaluatingSeconds() const
+{
+	return std::chrono::duration<double>(this->evaluating_).count();
+}
+
+} // namespace ai
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "movegenerator.h"
+#include "placement.h"
+#include "grid.h"
+
+#include <chrono>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Simulation;
+
+namespace ai {
+
+class IEvaluator;
+
+// Plays many games at once, a tetromino in each per round, greedily: the grids all placements of all games lead to go to
+// the evaluator in one batch, which is what lets a vectorizing evaluator like NetworkEvaluator work on full registers
+// rather than the handful of placements one game has. The buffers are kept from round to round, so after the first few
+// rounds a round does not allocate.
+class LockstepPlayer final
+{
+	const IEvaluator&                         evaluator_;
+	MoveGenerator                             generator_{};
+	std::vector<std::pair<size_t, Placement>> moves_{}; // the game and the placement, the moves of a game consecutive
+	std::vector<Grid>                         grids_{};
+	std::vector<const Grid*>                  batch_{};
+	std::vector<int>                          linesCleared_{};
+	std::vector<double>                       scores_{};
+	std::chrono::steady_clock::duration       evaluating_{};
+	uint64_t                                  evaluations_{};
+
+public:
+	explicit LockstepPlayer(const IEvaluator& evaluator);
+
+	// Places the playing tetromino of every game that is not over at its best placement. Returns the number of games that
+	// placed one.
+	size_t round(Simulation* simulations, size_t count);
+
+	// Grids scored so far, and the time spent in the evaluator on them.
+	uint64_t evaluations() const;
+	double   evaluatingSeconds() const;
+};
+
+} // namespace ai
@@ -0,0 +1,162 @@
+#include "montecarlosearch.h"
+#include "ievaluator.h"
+#include "simulation.h"
+#include "threadpool.h"
+#include "xoshiro256.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ai {
+
+namespace {
+
+// The outcome of a rollout that tops out, far below that of any board.
+constexpr double TOP_OUT = -1e6;
+
+// What a thread needs to play rollouts. Set up on first use and reused after that, so the rollouts themselves neither
+// allocate nor touch memory that other threads write.
+struct Arena final
+{
+	GameState     state{};
+	Simulation    simulation{};
+	MoveGenerator generator{};
+};
+
+} // namespace
+
+double MonteCarloSearch::rollout(const GameState& state, const Placement& placement, uint64_t seed) const
+{
+	thread_local Arena arena{};
+
+	arena.state = state;
+	arena.state.bagOfSeven.reshuffle(seed);
+	arena.simulation.restore(arena.state);
+
+	auto&      board = arena.simulation.board();
+	const auto lines = board.lines();
+
+	arena.simulation.lockAt(placement.rotation, GridPosition{ placement.row, placement.column });
+	for (int i = 0; i < this->options_.horizon && !board.gameOver(); ++i)
+	{
+		const auto type = board.playingTetromino()->tetromino().type();
+
+		// Greedy: the placement that leaves the best board.
+		const Placement* best{};
+		auto             bestScore = 0.0;
+		for (const auto& candidate : arena.generator.generate(board.grid(), type))
+		{
+			auto grid = board.grid();
+			grid.place(Tetromino{ type, candidate.rotation }, GridPosition{ candidate.row, candidate.column });
+			const auto cleared = grid.clearFullLines();
+			const auto score   = this->evaluator_.evaluate(grid, cleared);
+			if (!best || score > bestScore)
+			{
+				best      = &candidate;
+				bestScore = score;
+			}
+		}
+		assert(best);
+		arena.simulation.lockAt(best->rotation, GridPosition{ best->row, best->column });
+	}
+
+	if (board.gameOver())
+	{
+		return TOP_OUT;
+	}
+	return this->evaluator_.evaluate(board.grid(), static_cast<int>(board.lines() - lines));
+}
+
+MonteCarloSearch::MonteCarloSearch(const IEvaluator& evaluator, const Options& options, ThreadPool* pool)
+    : evaluator_{ evaluator }
+    , options_{ options }
+    , pool_{ pool }
+{
+	assert(options.candidates > 0 && options.rollouts > 0 && options.horizon >= 0);
+}
+
+const MonteCarloSearch::Options& MonteCarloSearch::options() const
+{
+	return this->options_;
+}
+
+std::optional<Placement> MonteCarloSearch::choose(const GameState& state)
+{
+	const auto playingTetromino = state.board->playingTetromino();
+	if (!playingTetromino)
+	{
+		return std::nullopt;
+	}
+
+	// Rank the placements by the board they leave, and keep the best ones.
+	const auto  type = playingTetromino->tetromino().type();
+	const auto& grid = state.board->grid();
+	this->candidates_.clear();
+	for (const auto& placement : this->generator_.generate(grid, type))
+	{
+		auto next = grid;
+		next.place(Tetromino{ type, placement.rotation }, GridPosition{ placement.row, placement.column });
+		const auto cleared = next.clearFullLines();
+		this->candidates_.push_back(Candidate{ placement, this->evaluator_.evaluate(next, cleared) });
+	}
+	if (this->candidates_.empty())
+	{
+		return std::nullopt;
+	}
+	std::stable_sort(this->candidates_.begin(), this->candidates_.end(), [](const Candidate& a, const Candidate& b) {
+		return a.score > b.score;
+	});
+	if (static_cast<int>(this->candidates_.size()) > this->options_.candidates)
+	{
+		this->candidates_.resize(this->options_.candidates);
+	}
+
+	// Rollout i of each candidate is dealt from the same seed.
+	const auto candidates = this->candidates_.size();
+	const auto rollouts   = static_cast<size_t>(this->options_.rollouts);
+	const auto seed       = Xoshiro256{ this->options_.seed + this->decisions_++ }();
+	this->outcomes_.resize(candidates * rollouts);
+
+	const auto play = [&](size_t i) {
+		const auto& candidate = this->candidates_[i / rollouts];
+		this->outcomes_[i]    = this->rollout(state, candidate.placement, Xoshiro256{ seed + i % rollouts }());
+	};
+	if (this->pool_)
+	{
+		this->pool_->parallelFor(this->outcomes_.size(), play);
+	}
+	else
+	{
+		for (size_t i = 0; i < this->outcomes_.size(); ++i)
+		{
+			play(i);
+		}
+	}
+	this->rollouts_ += this->outcomes_.size();
+
+	// The sums are taken in a fixed order, so the choice is the same however the rollouts were spread over threads.
+	size_t best{};
+	auto   bestMean = 0.0;
+	for (size_t c = 0; c < candidates; ++c)
+	{
+		auto sum = 0.0;
+		for (size_t r = 0; r < rollouts; ++r)
+		{
+			sum += this->outcomes_[c * rollouts + r];
+		}
+		const auto mean = sum / rollouts;
+		if (c == 0 || mean > bestMean)
+		{
+			best     = c;
+			bestMean = mean;
+		}
+	}
+	return this->candidates_[best].placement;
+}
+
+uint64_t MonteCarloSearch::rollouts() const
+{
+	return this->rollouts_;
+}
+
+} // namespace ai
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "isearch.h"
+#include "movegenerator.h"
+#include "gamestate.h"
+
+#include <vector>
+#include <cstdint>
+
+class ThreadPool;
+
+namespace ai {
+
+class IEvaluator;
+
+// Judges placements by playing them out. The most promising placements by the evaluator are each followed by many
+// rollouts: short games on the headless engine with a freshly shuffled bag, in which a greedy player places the following
+// tetrominoes. The placement with the best mean outcome wins. Where the evaluator only sees the next board, the rollouts
+// also see how often a placement leads to trouble later on.
+//
+// Rollouts run on the thread pool when one is given. Each thread plays them in its own arena, and rollout i of every
+// placement deals the same tetrominoes, so placements are compared on equal terms and the choice does not depend on the
+// number of threads.
+class MonteCarloSearch final : public ISearch
+{
+public:
+	struct Options final
+	{
+		int      candidates = 6;  // placements played out
+		int      rollouts   = 32; // rollouts per placement
+		int      horizon    = 8;  // tetrominoes placed in a rollout after the placement itself
+		uint64_t seed       = 1;
+	};
+
+private:
+	struct Candidate final
+	{
+		Placement placement;
+		double    score;
+	};
+
+	const IEvaluator&      evaluator_;
+	Options                options_;
+	ThreadPool*            pool_;
+	MoveGenerator          generator_{};
+	std::vector<Candidate> candidates_{};
+	std::vector<double>    outcomes_{};
+	uint64_t               decisions_{};
+	uint64_t               rollouts_{};
+
+	double rollout(const GameState& state, const Placement& placement, uint64_t seed) const;
+
+public:
+	MonteCarloSearch(const IEvaluator& evaluator, const Options& options, ThreadPool* pool = nullptr);
+
+	const Options& options() const;
+
+	std::optional<Placement> choose(const GameState& state) override;
+	uint64_t                 rollouts() const override;
+};
+
+} // namespace ai
@@ -0,0 +1,184 @@
+#include "movegenerator.h"
+#include "board.h"
+#include "bits.h"
+#include "rotationdirection.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ai {
+
+namespace {
+
+constexpr int ROTATIONS = 4;
+uint32_t shift(uint32_t bits, int offset)
+{
+	return offset >= 0 ? bits << offset : bits >> -offset;
+}
+
+} // namespace
+
+// A position is free when none of the tetromino's minos overlaps a mino, a wall, the floor or the space above the grid. With
+// the grid rows widened by walls, mino Offset{ x, y } is blocked for exactly the positions whose bit is set in (row y) >> x.
+void MoveGenerator::computeFree(const Grid& grid, TetrominoType type)
+{
+	std::array<uint32_t, ROWS + 4> walled{};
+	for (int i = 0; i < static_cast<int>(walled.size()); ++i)
+	{
+		const auto row = i - OFFSET;
+		walled[i]      = (row < 0 || row >= Grid::height()) ? ~0u : (uint32_t{ grid.rowBits(row) } << OFFSET) | ~(((1u << Grid::width()) - 1) << OFFSET);
+	}
+
+	for (int rotation = 0; rotation < ROTATIONS; ++rotation)
+	{
+		const auto& state = Tetromino::rotationState(type, rotation);
+		for (int i = 0; i < ROWS; ++i)
+		{
+			uint32_t blocked{};
+			for (const auto& offs : state)
+			{
+				blocked |= walled[i + offs.y] >> offs.x;
+			}
+			this->free_[rotation][i] = static_cast<PositionBits>(~blocked & POSITION_MASK);
+		}
+	}
+}
+
+// Grows the reachable sets until nothing changes. Returns false when the tetromino cannot even enter the grid.
+bool MoveGenerator::flood(TetrominoType type)
+{
+	for (auto& rows : this->reachable_)
+	{
+		rows.fill(0);
+	}
+
+	const auto initial = Board::initialTetrominoPosition();
+	const auto start   = PositionBits(1u << (initial.column + OFFSET));
+	if (!(this->free_[0][initial.row + OFFSET] & start))
+	{
+		return false;
+	}
+	this->reachable_[0][initial.row + OFFSET] = start;
+
+	const auto wallKickMap = Tetromino::wallKickMap(type);
+
+	for (auto changed = true; changed;)
+	{
+		changed = false;
+		for (int rotation = 0; rotation < ROTATIONS; ++rotation)
+		{
+			auto&       reachable = this->reachable_[rotation];
+			const auto& free      = this->free_[rotation];
+			for (int i = 0; i < ROWS; ++i)
+			{
+				uint32_t bits = reachable[i];
+				if (!bits)
+				{
+					continue;
+				}
+
+				// Shift left and right as far as the row allows.
+				for (uint32_t grown = bits;; bits = grown)
+				{
+					grown = (bits | (bits << 1) | (bits >> 1)) & free[i];
+					if (grown == bits)
+					{
+						break;
+					}
+				}
+				if (bits != reachable[i])
+				{
+					reachable[i] = static_cast<PositionBits>(bits);
+					changed      = true;
+				}
+
+				// Soft drop one row.
+				if (i + 1 < ROWS)
+				{
+					const auto dropped = reachable[i + 1] | (bits & free[i + 1]);
+					if (dropped != reachable[i + 1])
+					{
+						reachable[i + 1] = static_cast<PositionBits>(dropped);
+						changed          = true;
+					}
+				}
+
+				// Rotate both ways. Each position takes the first of the SRS tests that fits, in order.
+				for (const auto direction : { RotationDirection::CLOCKWISE, RotationDirection::COUNTER_CLOCKWISE })
+				{
+					const auto target = (rotation + ROTATIONS + static_cast<int>(direction)) % ROTATIONS;
+					auto&      into   = this->reachable_[target];
+					const auto rotate = [&](uint32_t sources, int dx, int dy) {
+						const auto row = i - dy;
+						if (row < 0 || row >= ROWS)
+						{
+							return sources;
+						}
+						const auto fits = shift(sources, dx) & this->free_[target][row] & POSITION_MASK;
+						if ((into[row] | fits) != into[row])
+						{
+							into[row] = static_cast<PositionBits>(into[row] | fits);
+							changed   = true;
+						}
+						return sources & ~shift(fits, -dx);
+					};
+
+					auto sources = rotate(bits, 0, 0);
+					if (wallKickMap)
+					{
+						for (const auto& kick : (*wallKickMap)[rotation][rotation_direction_index(direction)])
+						{
+							if (!sources)
+							{
+								break;
+							}
+							sources = rotate(sources, kick.x, kick.y);
+						}
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+MoveGenerator::MoveGenerator()
+{
+	this->keys_.reserve(ROTATIONS * ROWS * 16);
+	this->placements_.reserve(ROTATIONS * ROWS * 16);
+}
+
+const std::vector<Placement>& MoveGenerator::generate(const Grid& grid, TetrominoType type)
+{
+	this->placements_.clear();
+	this->keys_.clear();
+
+	this->computeFree(grid, type);
+	if (!this->flood(type))
+	{
+		return this->placements_;
+	}
+
+	for (int rotation = 0; rotation < ROTATIONS; ++rotation)
+	{
+		for (int i = 0; i < ROWS; ++i)
+		{
+			// A position locks when the one below it is not free.
+			const uint32_t below = i + 1 < ROWS ? this->free_[rotation][i + 1] : 0;
+			for (uint32_t locks = this->reachable_[rotation][i] & ~below; locks; locks &= locks - 1)
+			{
+				const auto placement = Placement{ rotation, i - OFFSET, countr_zero(locks) - OFFSET };
+				const auto key       = cell_key(type, placement);
+				if (std::find(this->keys_.begin(), this->keys_.end(), key) == this->keys_.end())
+				{
+					this->keys_.push_back(key);
+					this->placements_.push_back(placement);
+				}
+			}
+		}
+	}
+
+	return this->placements_;
+}
+
+} // namespace ai
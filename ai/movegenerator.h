@@ -0,0 +1,45 @@
+#pragma once
+
+#include "placement.h"
+#include "grid.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace ai {
+
+// Finds every position a tetromino can lock at, starting from where it enters the grid and moving it by shifts, soft drops
+// and SRS rotations with wall kicks, so tucks under overhangs and kicked spins are included. Rather than simulating key
+// presses one position at a time, it floods whole rows of positions at once: for each rotation and row a 16 bit mask holds
+// one bit per column, and shifts, drops and kicks are shifts and ANDs of those masks.
+//
+// Keeps its scratch space between calls, so use one instance per thread.
+class MoveGenerator final
+{
+	// Rows and columns of the tetromino position are offset by 3, so that positions partly outside the grid get a bit too.
+	static constexpr int OFFSET = 3;
+	static constexpr int ROWS   = Grid::height() + OFFSET;
+
+	using PositionBits = uint16_t;
+	using Rows         = std::array<PositionBits, ROWS>;
+
+	static constexpr uint32_t POSITION_MASK = (1u << (Grid::width() + OFFSET)) - 1;
+	static_assert(Grid::width() + OFFSET <= 16, "a row of positions must fit in PositionBits");
+
+	std::array<Rows, 4>    free_{};
+	std::array<Rows, 4>    reachable_{};
+	std::vector<uint64_t>  keys_{};
+	std::vector<Placement> placements_{};
+
+	void computeFree(const Grid& grid, TetrominoType type);
+	bool flood(TetrominoType type);
+
+public:
+	MoveGenerator();
+
+	// The returned placements stay valid until the next call.
+	const std::vector<Placement>& generate(const Grid& grid, TetrominoType type);
+};
+
+} // namespace ai
@@ -0,0 +1,347 @@
+#include "networkevaluator.h"
+#include "grid.h"
+#include "bits.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace ai {
+
+namespace {
+
+constexpr char     MAGIC[4] = { 'T', 'N', 'E', 'T' };
+constexpr uint32_t VERSION  = 1;
+
+constexpr int HEIGHT_INPUTS     = 0;
+constexpr int DIFFERENCE_INPUTS = HEIGHT_INPUTS + Grid::width();
+constexpr int HOLES_INPUT       = DIFFERENCE_INPUTS + Grid::width() - 1;
+constexpr int WELLS_INPUT       = HOLES_INPUT + 1;
+constexpr int MAX_HEIGHT_INPUT  = WELLS_INPUT + 1;
+constexpr int LINES_INPUT       = MAX_HEIGHT_INPUT + 1;
+
+static_assert(LINES_INPUT < NetworkEvaluator::INPUTS, "the features must fit in the inputs");
+
+// Grids whose inputs are gathered before one forward pass over all of them. Small enough for the inputs to stay in the
+// first level cache.
+constexpr size_t CHUNK = 256;
+
+using Network = NetworkEvaluator::Network;
+
+uint8_t clamp_input(int value)
+{
+	return static_cast<uint8_t>(std::min(std::max(value, 0), 127));
+}
+
+void inputs_of(const Grid& grid, int linesCleared, uint8_t* inputs)
+{
+	std::memset(inputs, 0, NetworkEvaluator::INPUTS);
+
+	int  wells{}, maxHeight{};
+	auto left   = Grid::height();
+	auto height = grid.columnHeight(0);
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		const auto right = column + 1 < Grid::width() ? grid.columnHeight(column + 1) : Grid::height();
+
+		inputs[HEIGHT_INPUTS + column] = static_cast<uint8_t>(height);
+		if (column + 1 < Grid::width())
+		{
+			inputs[DIFFERENCE_INPUTS + column] = static_cast<uint8_t>(std::abs(height - right));
+		}
+		wells += std::max(0, std::min(left, right) - height);
+		maxHeight = std::max(maxHeight, height);
+
+		left   = height;
+		height = right;
+	}
+
+	inputs[HOLES_INPUT]      = clamp_input(grid.holes());
+	inputs[WELLS_INPUT]      = clamp_input(wells);
+	inputs[MAX_HEIGHT_INPUT] = static_cast<uint8_t>(maxHeight);
+	inputs[LINES_INPUT]      = clamp_input(linesCleared);
+}
+
+int32_t forward_scalar(const Network& network, const uint8_t* inputs)
+{
+	auto output = network.outputBias;
+	for (int j = 0; j < NetworkEvaluator::HIDDEN; ++j)
+	{
+		auto        sum     = network.hiddenBiases[j];
+		const auto& weights = network.hiddenWeights[j];
+		for (int i = 0; i < NetworkEvaluator::INPUTS; ++i)
+		{
+			sum += weights[i] * inputs[i];
+		}
+		const auto hidden = std::min(std::max(sum >> network.hiddenShift, 0), 127);
+		output += network.outputWeights[j] * hidden;
+	}
+	return output;
+}
+
+void forward_scalar(const Network& network, const uint8_t* inputs, size_t count, int32_t* outputs)
+{
+	for (size_t b = 0; b < count; ++b)
+	{
+		outputs[b] = forward_scalar(network, inputs + b * NetworkEvaluator::INPUTS);
+	}
+}
+
+#ifdef HAVE_AVX2_KERNELS
+
+static_assert(NetworkEvaluator::INPUTS == 32 && NetworkEvaluator::HIDDEN == 32,
+              "the AVX2 kernel takes one register of inputs and of hidden units");
+
+// The sum of the eight 32 bit lanes.
+AVX2_KERNEL inline int32_t sum_lanes(__m256i x)
+{
+	auto sum = _mm_add_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+	sum      = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum      = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+// Inputs and hidden units fit in 0..127, and weights in -128..127, so the pairwise 16 bit sums of _mm256_maddubs_epi16
+// never saturate and the result equals that of forward_scalar().
+AVX2_KERNEL void forward_avx2(const Network& network, const uint8_t* inputs, size_t count, int32_t* outputs)
+{
+	const auto ones          = _mm256_set1_epi16(1);
+	const auto zero          = _mm256_setzero_si256();
+	const auto shift         = _mm_cvtsi32_si128(network.hiddenShift);
+	const auto order         = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	const auto outputWeights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(network.outputWeights.data()));
+
+	for (size_t b = 0; b < count; ++b)
+	{
+		const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs + b * NetworkEvaluator::INPUTS));
+
+		// Eight hidden units at a time: eight dot products of eight 32 bit partial sums each, added up pairwise.
+		__m256i hidden[4];
+		for (int group = 0; group < 4; ++group)
+		{
+			__m256i sums[8];
+			for (int k = 0; k < 8; ++k)
+			{
+				const auto w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(network.hiddenWeights[group * 8 + k].data()));
+				sums[k]      = _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones);
+			}
+			const auto s0123  = _mm256_hadd_epi32(_mm256_hadd_epi32(sums[0], sums[1]), _mm256_hadd_epi32(sums[2], sums[3]));
+			const auto s4567  = _mm256_hadd_epi32(_mm256_hadd_epi32(sums[4], sums[5]), _mm256_hadd_epi32(sums[6], sums[7]));
+			const auto low    = _mm256_permute2x128_si256(s0123, s4567, 0x20);
+			const auto high   = _mm256_permute2x128_si256(s0123, s4567, 0x31);
+			const auto biases = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(network.hiddenBiases.data() + group * 8));
+			hidden[group]     = _mm256_sra_epi32(_mm256_add_epi32(_mm256_add_epi32(low, high), biases), shift);
+		}
+
+		// Saturating packs clamp to 127 and the max to 0. Packing works within 128 bit lanes, which the permutation undoes.
+		auto units = _mm256_packs_epi16(_mm256_packs_epi32(hidden[0], hidden[1]), _mm256_packs_epi32(hidden[2], hidden[3]));
+		units      = _mm256_permutevar8x32_epi32(_mm256_max_epi8(units, zero), order);
+
+		outputs[b] = network.outputBias + sum_lanes(_mm256_madd_epi16(_mm256_maddubs_epi16(units, outputWeights), ones));
+	}
+}
+
+#endif
+
+uint32_t read_word(std::istream& in)
+{
+	unsigned char bytes[4]{};
+	in.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+	return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+void write_word(std::ostream& out, uint32_t word)
+{
+	const unsigned char bytes[4] = { static_cast<unsigned char>(word),
+		                             static_cast<unsigned char>(word >> 8),
+		                             static_cast<unsigned char>(word >> 16),
+		                             static_cast<unsigned char>(word >> 24) };
+	out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+template<size_t N>
+void read_bytes(std::istream& in, std::array<int8_t, N>& bytes)
+{
+	in.read(reinterpret_cast<char*>(bytes.data()), N);
+}
+
+template<size_t N>
+void write_bytes(std::ostream& out, const std::array<int8_t, N>& bytes)
+{
+	out.write(reinterpret_cast<const char*>(bytes.data()), N);
+}
+
+} // namespace
+
+Network Network::load(const std::string& path)
+{
+	std::ifstream in{ path, std::ios::binary };
+
+	char magic[sizeof(MAGIC)]{};
+	in.read(magic, sizeof(magic));
+	if (!in || !std::equal(std::begin(magic), std::end(magic), std::begin(MAGIC)) || read_word(in) != VERSION ||
+	    read_word(in) != static_cast<uint32_t>(INPUTS) || read_word(in) != static_cast<uint32_t>(HIDDEN))
+	{
+		throw std::runtime_error{ "not a network weights file: " + path };
+	}
+
+	Network network{};
+	for (auto& weights : network.hiddenWeights)
+	{
+		read_bytes(in, weights);
+	}
+	for (auto& bias : network.hiddenBiases)
+	{
+		bias = static_cast<int32_t>(read_word(in));
+	}
+	network.hiddenShift = static_cast<int32_t>(read_word(in));
+	read_bytes(in, network.outputWeights);
+	network.outputBias = static_cast<int32_t>(read_word(in));
+
+	const auto scale = read_word(in);
+	std::memcpy(&network.outputScale, &scale, sizeof(scale));
+
+	if (!in || network.hiddenShift < 0 || network.hiddenShift > 31)
+	{
+		throw std::runtime_error{ "truncated or corrupt network weights file: " + path };
+	}
+	return network;
+}
+
+void Network::save(const std::string& path) const
+{
+	std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+
+	out.write(MAGIC, sizeof(MAGIC));
+	write_word(out, VERSION);
+	write_word(out, INPUTS);
+	write_word(out, HIDDEN);
+	for (const auto& weights : this->hiddenWeights)
+	{
+		write_bytes(out, weights);
+	}
+	for (const auto bias : this->hiddenBiases)
+	{
+		write_word(out, static_cast<uint32_t>(bias));
+	}
+	write_word(out, static_cast<uint32_t>(this->hiddenShift));
+	write_bytes(out, this->outputWeights);
+	write_word(out, static_cast<uint32_t>(this->outputBias));
+
+	uint32_t scale{};
+	std::memcpy(&scale, &this->outputScale, sizeof(scale));
+	write_word(out, scale);
+
+	out.flush();
+	if (!out)
+	{
+		throw std::runtime_error{ "cannot write network weights file: " + path };
+	}
+}
+
+Network Network::of(const HeuristicEvaluator::Weights& weights)
+{
+	// One hidden unit per feature, passing it through unscaled. Hidden units clamp at 127, so the aggregate height (up to
+	// 200) and the bumpiness (up to 180) each take two units, over five columns and over five and four column differences.
+	Network network{};
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		network.hiddenWeights[column < Grid::width() / 2 ? 0 : 1][HEIGHT_INPUTS + column] = 1;
+	}
+	for (int column = 0; column + 1 < Grid::width(); ++column)
+	{
+		network.hiddenWeights[column < Grid::width() / 2 ? 3 : 6][DIFFERENCE_INPUTS + column] = 1;
+	}
+	network.hiddenWeights[2][HOLES_INPUT] = 1;
+	network.hiddenWeights[4][WELLS_INPUT] = 1;
+	network.hiddenWeights[5][LINES_INPUT] = 1;
+
+	const double output[] = { weights.aggregateHeight,
+		                      weights.aggregateHeight,
+		                      weights.holes,
+		                      weights.bumpiness,
+		                      weights.wells,
+		                      weights.linesCleared,
+		                      weights.bumpiness };
+
+	double largest{};
+	for (const auto weight : output)
+	{
+		largest = std::max(largest, std::abs(weight));
+	}
+	network.outputScale = largest > 0.0 ? static_cast<float>(largest / 127.0) : 1.0f;
+	for (size_t j = 0; j < std::size(output); ++j)
+	{
+		network.outputWeights[j] = static_cast<int8_t>(std::lround(output[j] / network.outputScale));
+	}
+	return network;
+}
+
+NetworkEvaluator::NetworkEvaluator(const Network& network, bool vectorize)
+    : network_{ network }
+#ifdef HAVE_AVX2_KERNELS
+    , vectorized_{ vectorize && cpu_has_avx2() }
+#else
+    , vectorized_{ false }
+#endif
+{
+	(void)vectorize;
+}
+
+const NetworkEvaluator::Network& NetworkEvaluator::network() const
+{
+	return this->network_;
+}
+
+bool NetworkEvaluator::vectorized() const
+{
+	return this->vectorized_;
+}
+
+double NetworkEvaluator::evaluate(const Grid& grid, int linesCleared) const
+{
+	uint8_t inputs[INPUTS];
+	inputs_of(grid, linesCleared, inputs);
+	return forward_scalar(this->network_, inputs) * static_cast<double>(this->network_.outputScale);
+}
+
+void NetworkEvaluator::evaluateBatch(const Grid* const* grids, const int* linesCleared, double* scores, size_t count) const
+{
+	thread_local std::array<uint8_t, CHUNK * INPUTS> inputs{};
+	thread_local std::array<int32_t, CHUNK>          outputs{};
+
+	for (size_t first = 0; first < count; first += CHUNK)
+	{
+		const auto n = std::min(CHUNK, count - first);
+		for (size_t b = 0; b < n; ++b)
+		{
+			inputs_of(*grids[first + b], linesCleared[first + b], inputs.data() + b * INPUTS);
+		}
+
+#ifdef HAVE_AVX2_KERNELS
+		if (this->vectorized_)
+		{
+			forward_avx2(this->network_, inputs.data(), n, outputs.data());
+		}
+		else
+#endif
+		{
+			forward_scalar(this->network_, inputs.data(), n, outputs.data());
+		}
+
+		for (size_t b = 0; b < n; ++b)
+		{
+			scores[first + b] = outputs[b] * static_cast<double>(this->network_.outputScale);
+		}
+	}
+}
+
+} // namespace ai
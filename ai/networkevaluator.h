@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ievaluator.h"
+#include "heuristicevaluator.h"
+
+#include <array>
+#include <string>
+#include <cstdint>
+
+namespace ai {
+
+// A small multilayer perceptron over board features, run in 8 bit integers: one layer of rectified hidden units and a
+// linear output. The same integer arithmetic runs with AVX2 when the processor has it and in plain C++ otherwise, so both
+// give the same scores.
+//
+// The inputs are the ten column heights, the nine height differences of neighbouring columns, the holes, the wells, the
+// height of the highest column and the lines cleared, followed by zeros up to INPUTS. Inputs are 0..127, the range the
+// AVX2 multiply takes; the holes and wells, which can exceed it on a grid full of gaps, are clamped.
+class NetworkEvaluator final : public IEvaluator
+{
+public:
+	static constexpr int INPUTS = 32;
+	static constexpr int HIDDEN = 32;
+
+	struct Network final
+	{
+		// Hidden unit j is (hiddenWeights[j] . inputs + hiddenBiases[j]) >> hiddenShift, clamped to 0..127.
+		std::array<std::array<int8_t, INPUTS>, HIDDEN> hiddenWeights{};
+		std::array<int32_t, HIDDEN>                    hiddenBiases{};
+		int32_t                                        hiddenShift{};
+
+		// The score is (outputWeights . hidden + outputBias) * outputScale.
+		std::array<int8_t, HIDDEN> outputWeights{};
+		int32_t                    outputBias{};
+		float                      outputScale = 1.0f;
+
+		// The file holds "TNET", the format version, INPUTS and HIDDEN as 32 bit words, then the members above in order,
+		// everything little endian. Both throw std::runtime_error when the file cannot be read or written.
+		static Network load(const std::string& path);
+		void           save(const std::string& path) const;
+
+		// A network that computes the weighted sum of the heuristic evaluator, up to the rounding of the weights to 8 bits,
+		// on grids with at most 127 holes and 127 cells of wells. Beyond that the clamped inputs score them as if at 127.
+		static Network of(const HeuristicEvaluator::Weights& weights);
+	};
+
+private:
+	Network network_;
+	bool    vectorized_;
+
+public:
+	// With vectorize unset, or on a processor without AVX2, the plain C++ kernel runs.
+	explicit NetworkEvaluator(const Network& network, bool vectorize = true);
+
+	const Network& network() const;
+	bool           vectorized() const;
+
+	double evaluate(const Grid& grid, int linesCleared) const override;
+	void   evaluateBatch(const Grid* const* grids, const int* linesCleared, double* scores, size_t count) const override;
+};
+
+} // namespace ai
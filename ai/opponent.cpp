@@ -0,0 +1,29 @@
+#include "opponent.h"
+#include "gamestate.h"
+#include "inputevent.h"
+
+namespace ai {
+
+Opponent::Opponent(std::unique_ptr<ISearch> search, int pace, uint64_t seed)
+    : player_{ std::move(search) }
+    , pace_{ pace }
+    , random_{ seed }
+{
+}
+
+std::optional<InputEvent> Opponent::act(const GameState& state)
+{
+	if (state.frame < this->next_ || state.board->gameOver())
+	{
+		return std::nullopt;
+	}
+	const auto input = this->player_.nextInput(state);
+	if (input)
+	{
+		// Half the pace to one and a half times it.
+		this->next_ = state.frame + this->pace_ / 2 + this->random_.below(static_cast<uint32_t>(this->pace_) + 1);
+	}
+	return input;
+}
+
+} // namespace ai
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "aiplayer.h"
+#include "xoshiro256.h"
+
+#include <memory>
+#include <optional>
+#include <cstdint>
+
+struct GameState;
+enum class InputEvent;
+
+namespace ai {
+
+// An AI player for real-time play against others: an input every so many frames, towards the placement its search chose,
+// so that it plays at a pace a person can keep up with rather than placing tetrominoes outright. The frames between inputs
+// vary around the pace, drawn from the seed, or opponents with the same search dealt the same tetrominoes would play the
+// same game.
+class Opponent final
+{
+	AiPlayer   player_;
+	int        pace_;
+	Xoshiro256 random_;
+	uint64_t   next_{};
+
+public:
+	Opponent(std::unique_ptr<ISearch> search, int pace, uint64_t seed);
+
+	// The input to make at the frame of the state, when one is due.
+	std::optional<InputEvent> act(const GameState& state);
+};
+
+} // namespace ai
@@ -0,0 +1,104 @@
+#include "pathfinder.h"
+#include "playingtetromino.h"
+#include "grid.h"
+#include "inputevent.h"
+#include "rotationdirection.h"
+#include "offset.h"
+
+#include <algorithm>
+#include <array>
+
+namespace ai {
+
+namespace {
+
+// Accepted positions range from -3 to the last row or column.
+constexpr int OFFSET  = 3;
+constexpr int ROWS    = Grid::height() + OFFSET;
+constexpr int COLUMNS = Grid::width() + OFFSET;
+constexpr int STATES  = 4 * ROWS * COLUMNS;
+
+constexpr std::array<InputEvent, 5> MOVES{
+	InputEvent::MOVE_LEFT, InputEvent::MOVE_RIGHT, InputEvent::ROTATE_CLOCKWISE, InputEvent::ROTATE_COUNTER_CLOCKWISE, InputEvent::SOFT_DROP,
+};
+
+int state_index(const PlayingTetromino& playingTetromino)
+{
+	const auto& position = playingTetromino.position();
+	return (playingTetromino.tetromino().rotation() * ROWS + position.row + OFFSET) * COLUMNS + position.column + OFFSET;
+}
+
+bool apply(const Grid& grid, PlayingTetromino& playingTetromino, InputEvent move)
+{
+	switch (move)
+	{
+	case InputEvent::MOVE_LEFT:
+		return playingTetromino.move(grid, Offset{ -1, 0 });
+	case InputEvent::MOVE_RIGHT:
+		return playingTetromino.move(grid, Offset{ +1, 0 });
+	case InputEvent::SOFT_DROP:
+		return playingTetromino.move(grid, Offset{ 0, +1 });
+	case InputEvent::ROTATE_CLOCKWISE:
+		return playingTetromino.rotate(grid, RotationDirection::CLOCKWISE);
+	case InputEvent::ROTATE_COUNTER_CLOCKWISE:
+		return playingTetromino.rotate(grid, RotationDirection::COUNTER_CLOCKWISE);
+	default:
+		return false;
+	}
+}
+
+} // namespace
+
+std::optional<std::vector<InputEvent>> find_path(const Grid& grid, const PlayingTetromino& playingTetromino, const Placement& placement)
+{
+	struct Visit final
+	{
+		int        parent;
+		InputEvent move;
+	};
+
+	const auto type   = playingTetromino.tetromino().type();
+	const auto target = cell_key(type, placement);
+
+	// Breadth first, so the first state that hard drops onto the placement is reached with the fewest inputs.
+	std::array<bool, STATES>      visited{};
+	std::array<Visit, STATES>     visits{};
+	std::vector<PlayingTetromino> queue{ playingTetromino };
+	visited[state_index(playingTetromino)] = true;
+	visits[state_index(playingTetromino)]  = Visit{ -1, InputEvent::HARD_DROP };
+
+	for (size_t next = 0; next < queue.size(); ++next)
+	{
+		const auto current = queue[next];
+		const auto ghost   = current.ghostPosition(grid);
+		if (cell_key(type, Placement{ current.tetromino().rotation(), ghost.row, ghost.column }) == target)
+		{
+			std::vector<InputEvent> path{ InputEvent::HARD_DROP };
+			for (auto index = state_index(current); visits[index].parent != -1; index = visits[index].parent)
+			{
+				path.push_back(visits[index].move);
+			}
+			std::reverse(path.begin(), path.end());
+			return path;
+		}
+
+		for (const auto move : MOVES)
+		{
+			auto moved = current;
+			if (apply(grid, moved, move))
+			{
+				const auto index = state_index(moved);
+				if (!visited[index])
+				{
+					visited[index] = true;
+					visits[index]  = Visit{ state_index(current), move };
+					queue.push_back(moved);
+				}
+			}
+		}
+	}
+
+	return std::nullopt;
+}
+
+} // namespace ai
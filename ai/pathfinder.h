@@ -0,0 +1,19 @@
+#pragma once
+
+#include "placement.h"
+
+#include <optional>
+#include <vector>
+
+class Grid;
+class PlayingTetromino;
+enum class InputEvent;
+
+namespace ai {
+
+// The shortest sequence of inputs that takes the playing tetromino to the placement, ending with a hard drop. Soft drops are
+// only used where a hard drop would not get there, i.e. for tucks and spins under overhangs. Gravity is not modelled: a
+// real-time player should look for a new path after every input.
+std::optional<std::vector<InputEvent>> find_path(const Grid& grid, const PlayingTetromino& playingTetromino, const Placement& placement);
+
+} // namespace ai
@@ -0,0 +1,326 @@
+#include "perfectclearsolver.h"
+#include "movegenerator.h"
+#include "grid.h"
+#include "gridposition.h"
+#include "gamestate.h"
+#include "threadpool.h"
+#include "bits.h"
+#include "zobrist.h"
+#include "xoshiro256.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <cstdlib>
+
+namespace ai {
+
+namespace {
+
+constexpr int MAX_LINES  = 6;
+constexpr int MAX_PIECES = MAX_LINES * Grid::width() / 4;
+
+// The bottom rows of a grid packed into one word, 10 bits per row: bit c + 10 * i is column c of the i-th row from the
+// bottom.
+using Area = uint64_t;
+
+static_assert(MAX_LINES * Grid::width() <= 64, "the lines to clear must fit in an Area");
+
+constexpr Area row_mask(int rows)
+{
+	return rows == 0 ? 0 : (Area{ 1 } << (rows * Grid::width())) - 1;
+}
+
+constexpr Area column_mask(int column)
+{
+	Area mask{};
+	for (int row = 0; row < MAX_LINES; ++row)
+	{
+		mask |= Area{ 1 } << (row * Grid::width() + column);
+	}
+	return mask;
+}
+
+constexpr Area even_columns_mask()
+{
+	Area mask{};
+	for (int column = 0; column < Grid::width(); column += 2)
+	{
+		mask |= column_mask(column);
+	}
+	return mask;
+}
+
+constexpr Area EVEN_COLUMNS = even_columns_mask();
+
+// Clearing lines only ever brings cells of the same column together, so the empty cells of neighbouring columns can only
+// be joined by a tetromino when some row has both of them empty. Each group of columns joined that way is filled on its
+// own and must have a multiple of four empty cells.
+bool column_groups_fillable(Area empty)
+{
+	int cells{};
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		cells += popcount64(empty & column_mask(column));
+		const auto joined = column + 1 < Grid::width() && (empty & (empty >> 1) & column_mask(column)) != 0;
+		if (!joined)
+		{
+			if (cells % 4 != 0)
+			{
+				return false;
+			}
+			cells = 0;
+		}
+	}
+	return true;
+}
+
+// The empty cells of the bottom rows, or nullopt when a mino sticks out above them.
+std::optional<Area> empty_area(const Grid& grid, int lines)
+{
+	for (int column = 0; column < Grid::width(); ++column)
+	{
+		if (grid.columnHeight(column) > lines)
+		{
+			return std::nullopt;
+		}
+	}
+
+	Area empty{};
+	for (int i = 0; i < lines; ++i)
+	{
+		const auto bits = grid.rowBits(Grid::height() - 1 - i);
+		empty |= static_cast<Area>(~bits & ((1u << Grid::width()) - 1)) << (i * Grid::width());
+	}
+	return empty;
+}
+
+} // namespace
+
+// The search under one placement of the first tetromino.
+struct PerfectClearSolver::Search final
+{
+	const std::vector<TetrominoType>& tetrominoes;
+	uint64_t                          salt; // keeps the positions of earlier solves apart in the memo
+	size_t                            root;
+	uint64_t                          nodes;
+
+	// The lowest first placement that a solution was found under, shared by all searches. A search under a higher first
+	// placement gives up, as its solution would not be used.
+	std::atomic<size_t>& solvedRoot;
+
+	bool abandoned() const
+	{
+		return this->solvedRoot.load(std::memory_order_relaxed) < this->root;
+	}
+};
+
+bool PerfectClearSolver::solve(Search& search, const Grid& grid, int placed, int lines, Solution& solution)
+{
+	thread_local MoveGenerator                                      generator{};
+	thread_local std::array<std::vector<Placement>, MAX_PIECES + 1> placements{};
+
+	++search.nodes;
+
+	const auto empty = empty_area(grid, lines);
+	if (!empty)
+	{
+		return false;
+	}
+	if (lines == 0)
+	{
+		return true;
+	}
+
+	// Exactly the next `needed` tetrominoes fill the empty cells.
+	const auto cells = popcount64(*empty);
+	if (cells % 4 != 0 || !column_groups_fillable(*empty))
+	{
+		return false;
+	}
+	const auto needed = cells / 4;
+	if (placed + needed > static_cast<int>(search.tetrominoes.size()))
+	{
+		return false;
+	}
+
+	// Column parity: O, S and Z always cover two cells in even and two in odd columns, J and L three and one, T either, and
+	// I either or all four. Clearing lines does not move cells between columns, so these are the only tetrominoes that can
+	// make up the difference between empty cells in even and in odd columns.
+	int jl{}, t{}, i{};
+	for (auto next = placed; next < placed + needed; ++next)
+	{
+		switch (search.tetrominoes[next])
+		{
+		case TetrominoType::J:
+		case TetrominoType::L:
+			++jl;
+			break;
+		case TetrominoType::T:
+			++t;
+			break;
+		case TetrominoType::I:
+			++i;
+			break;
+		default:
+			break;
+		}
+	}
+	const auto imbalance = popcount64(*empty & EVEN_COLUMNS) - popcount64(*empty & ~EVEN_COLUMNS);
+	if (std::abs(imbalance) > 2 * jl + 2 * t + 4 * i || (t == 0 && (imbalance - 2 * jl) % 4 != 0))
+	{
+		return false;
+	}
+
+	auto       seed = search.salt + static_cast<uint64_t>(placed);
+	const auto key  = grid.hash() ^ splitmix64(seed);
+	if (this->failed_.probe(key))
+	{
+		return false;
+	}
+
+	assert(placed <= MAX_PIECES);
+	const auto type  = search.tetrominoes[placed];
+	auto&      moves = placements[placed];
+	moves            = generator.generate(grid, type);
+
+	for (const auto& placement : moves)
+	{
+		if (search.abandoned())
+		{
+			return false;
+		}
+
+		// Only placements inside the lines left to clear.
+		const auto& box = Tetromino::boundingBox(type, placement.rotation);
+		if (placement.row + box.minY < Grid::height() - lines)
+		{
+			continue;
+		}
+
+		auto next = grid;
+		next.place(Tetromino{ type, placement.rotation }, GridPosition{ placement.row, placement.column });
+		const auto cleared = next.clearFullLines();
+
+		solution.push_back(placement);
+		if (this->solve(search, next, placed + 1, lines - cleared, solution))
+		{
+			return true;
+		}
+		solution.pop_back();
+	}
+
+	// Only a search that ran to the end proves that there is no solution.
+	if (!search.abandoned())
+	{
+		this->failed_.store(key, 0.0);
+	}
+	return false;
+}
+
+PerfectClearSolver::PerfectClearSolver(const Options& options, ThreadPool* pool)
+    : options_{ options }
+    , pool_{ pool }
+    , failed_{ options.memoEntries }
+{
+	assert(options.lines > 0 && options.lines <= MAX_LINES);
+}
+
+std::optional<PerfectClearSolver::Solution> PerfectClearSolver::solve(const Grid& grid, const std::vector<TetrominoType>& tetrominoes)
+{
+	if (tetrominoes.empty())
+	{
+		return std::nullopt;
+	}
+
+	const auto lines = this->options_.lines;
+	const auto type  = tetrominoes.front();
+	const auto salt  = Xoshiro256{ ++this->solves_ }();
+
+	// Each placement of the first tetromino is a separate search.
+	std::vector<Placement> roots{};
+	for (const auto& placement : this->generator_.generate(grid, type))
+	{
+		if (placement.row + Tetromino::boundingBox(type, placement.rotation).minY >= Grid::height() - lines)
+		{
+			roots.push_back(placement);
+		}
+	}
+
+	std::atomic<size_t>                  solvedRoot{ std::numeric_limits<size_t>::max() };
+	std::vector<std::optional<Solution>> solutions(roots.size());
+	std::vector<uint64_t>                nodes(roots.size());
+
+	const auto search = [&](size_t root) {
+		auto context = Search{ tetrominoes, salt, root, 0, solvedRoot };
+		if (context.abandoned())
+		{
+			return;
+		}
+
+		const auto& placement = roots[root];
+		auto        next      = grid;
+		next.place(Tetromino{ type, placement.rotation }, GridPosition{ placement.row, placement.column });
+		const auto cleared = next.clearFullLines();
+
+		auto solution = Solution{ placement };
+		if (this->solve(context, next, 1, lines - cleared, solution))
+		{
+			solutions[root] = std::move(solution);
+			for (auto solved = solvedRoot.load(); root < solved && !solvedRoot.compare_exchange_weak(solved, root);)
+			{
+			}
+		}
+		nodes[root] = context.nodes;
+	};
+	if (this->pool_)
+	{
+		this->pool_->parallelFor(roots.size(), search);
+	}
+	else
+	{
+		for (size_t root = 0; root < roots.size(); ++root)
+		{
+			search(root);
+		}
+	}
+
+	for (const auto count : nodes)
+	{
+		this->nodes_ += count;
+	}
+
+	const auto solved = solvedRoot.load();
+	if (solved == std::numeric_limits<size_t>::max())
+	{
+		return std::nullopt;
+	}
+	return solutions[solved];
+}
+
+uint64_t PerfectClearSolver::nodes() const
+{
+	return this->nodes_;
+}
+
+std::vector<TetrominoType> PerfectClearSolver::upcoming(const GameState& state, size_t count)
+{
+	std::vector<TetrominoType> tetrominoes{};
+	if (const auto playingTetromino = state.board->playingTetromino())
+	{
+		tetrominoes.push_back(playingTetromino->tetromino().type());
+	}
+	tetrominoes.push_back(state.board->nextTetromino().type());
+
+	auto dealer = state.bagOfSeven;
+	while (tetrominoes.size() < count)
+	{
+		tetrominoes.push_back(dealer.next());
+	}
+	tetrominoes.resize(std::min(tetrominoes.size(), count));
+	return tetrominoes;
+}
+
+} // namespace ai
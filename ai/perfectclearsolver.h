@@ -0,0 +1,60 @@
+#pragma once
+
+#include "placement.h"
+#include "movegenerator.h"
+#include "transpositiontable.h"
+
+#include <optional>
+#include <vector>
+#include <cstdint>
+
+class Grid;
+class ThreadPool;
+struct GameState;
+
+namespace ai {
+
+// Looks for a perfect clear: placements of the given tetrominoes, in the order they are dealt, that leave the grid empty
+// without stacking higher than a number of lines from the floor.
+//
+// Depth first, with cuts that hold however lines clear along the way: the empty cells of the lines still to clear must
+// number a multiple of four, in every group of columns that only a line clear can join as well, there must be enough
+// tetrominoes to fill them, and those tetrominoes must be able to make up the column parity of the empty cells.
+// Positions found to fail are remembered by grid hash, and the placements of the first tetromino are searched in
+// parallel.
+class PerfectClearSolver final
+{
+public:
+	struct Options final
+	{
+		int    lines       = 4; // at most 6
+		size_t memoEntries = 1 << 18;
+	};
+
+	using Solution = std::vector<Placement>;
+
+private:
+	struct Search;
+
+	Options            options_;
+	ThreadPool*        pool_;
+	MoveGenerator      generator_{};
+	TranspositionTable failed_;
+	uint64_t           solves_{};
+	uint64_t           nodes_{};
+
+	bool solve(Search& search, const Grid& grid, int placed, int lines, Solution& solution);
+
+public:
+	explicit PerfectClearSolver(const Options& options, ThreadPool* pool = nullptr);
+
+	std::optional<Solution> solve(const Grid& grid, const std::vector<TetrominoType>& tetrominoes);
+
+	// Positions visited by all solves so far.
+	uint64_t nodes() const;
+
+	// The playing and next tetromino, followed by what the dealer will deal, up to count tetrominoes.
+	static std::vector<TetrominoType> upcoming(const GameState& state, size_t count);
+};
+
+} // namespace ai
@@ -0,0 +1,20 @@
+#include "placement.h"
+
+namespace ai {
+
+uint64_t cell_key(TetrominoType type, const Placement& placement)
+{
+	const auto& masks = Tetromino::rotationMasks(type, placement.rotation);
+	const auto& box   = Tetromino::boundingBox(type, placement.rotation);
+
+	// The top row, then the column masks of the rows below it. A column mask fits in 12 bits, as columns range up to 10.
+	auto key = static_cast<uint64_t>(placement.row + box.minY) << 48;
+	for (int y = box.minY; y <= box.maxY; ++y)
+	{
+		const uint32_t mask = placement.column >= 0 ? uint32_t{ masks[y] } << placement.column : uint32_t{ masks[y] } >> -placement.column;
+		key |= static_cast<uint64_t>(mask) << (12 * (y - box.minY));
+	}
+	return key;
+}
+
+} // namespace ai
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "tetromino.h"
+
+#include <cstdint>
+
+namespace ai {
+
+// Where a tetromino locks: its rotation and the grid position of its rotation state. Placements that cover the same cells
+// (e.g. the two horizontal rotations of an S) are reported once.
+struct Placement final
+{
+	Rotation rotation;
+	int      row;
+	int      column;
+};
+
+// Identifies the cells a placement covers, so that equal keys mean equal cells whatever the rotation.
+uint64_t cell_key(TetrominoType type, const Placement& placement);
+
+} // namespace ai
@@ -0,0 +1,83 @@
+#include "transpositiontable.h"
+#include "grid.h"
+#include "zobrist.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ai {
+
+namespace {
+
+uint64_t to_bits(double value)
+{
+	uint64_t bits{};
+	std::memcpy(&bits, &value, sizeof bits);
+	return bits;
+}
+
+double from_bits(uint64_t bits)
+{
+	double value{};
+	std::memcpy(&value, &bits, sizeof value);
+	return value;
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t entries)
+    : entries_{}
+    , mask_{}
+{
+	size_t size = 1;
+	while (size < entries)
+	{
+		size <<= 1;
+	}
+	this->entries_ = std::make_unique<Entry[]>(size);
+	this->mask_    = size - 1;
+	this->clear();
+}
+
+size_t TranspositionTable::size() const
+{
+	return this->mask_ + 1;
+}
+
+void TranspositionTable::clear()
+{
+	// An all-zero entry would match key 0 with score 0, so empty entries are made to match no key at all.
+	for (size_t i = 0; i < this->size(); ++i)
+	{
+		this->entries_[i].check.store(~i, std::memory_order_relaxed);
+		this->entries_[i].score.store(0, std::memory_order_relaxed);
+	}
+}
+
+uint64_t TranspositionTable::key(const Grid& grid, int linesCleared, bool mirrored)
+{
+	auto       lines = static_cast<uint64_t>(linesCleared);
+	const auto hash  = mirrored ? std::min(grid.hash(), grid.mirroredHash()) : grid.hash();
+	return hash ^ splitmix64(lines);
+}
+
+std::optional<double> TranspositionTable::probe(uint64_t key) const
+{
+	const auto& entry = this->entries_[key & this->mask_];
+	const auto  score = entry.score.load(std::memory_order_relaxed);
+	if ((entry.check.load(std::memory_order_relaxed) ^ score) != key)
+	{
+		return std::nullopt;
+	}
+	return from_bits(score);
+}
+
+void TranspositionTable::store(uint64_t key, double score)
+{
+	auto&      entry = this->entries_[key & this->mask_];
+	const auto bits  = to_bits(score);
+	entry.check.store(key ^ bits, std::memory_order_relaxed);
+	entry.score.store(bits, std::memory_order_relaxed);
+}
+
+} // namespace ai
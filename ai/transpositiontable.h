@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+class Grid;
+
+namespace ai {
+
+// A fixed-size table of board scores that search threads share without locking. Each entry is a pair of 64 bit atomics:
+// the score, and the key XORed with the score. A probe only accepts an entry whose two words agree, so an entry torn by
+// two threads storing at once reads as a miss instead of as a wrong score. A store always replaces what was there.
+class TranspositionTable final
+{
+	struct Entry final
+	{
+		std::atomic<uint64_t> check;
+		std::atomic<uint64_t> score;
+	};
+
+	std::unique_ptr<Entry[]> entries_;
+	size_t                   mask_;
+
+public:
+	// The number of entries is rounded up to a power of two. Each entry takes 16 bytes.
+	explicit TranspositionTable(size_t entries);
+
+	size_t size() const;
+
+	// Not safe to call while other threads probe or store.
+	void clear();
+
+	// The key of a grid reached by clearing linesCleared lines. When mirrored is set, a grid and its left-right mirror image
+	// get the same key, which is only right for scores that do not change when the grid is mirrored.
+	static uint64_t key(const Grid& grid, int linesCleared, bool mirrored);
+
+	std::optional<double> probe(uint64_t key) const;
+	void                  store(uint64_t key, double score);
+};
+
+} // namespace ai
@@ -0,0 +1,143 @@
+#include "versusgame.h"
+#include "opponent.h"
+#include "beamsearch.h"
+#include "heuristicevaluator.h"
+#include "bagofseven.h"
+#include "gamestate.h"
+#include "inputevent.h"
+#include "itimer.h"
+
+#include <chrono>
+#include <vector>
+
+namespace ai {
+
+class VersusGame::impl final
+{
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr int TICK_MSEC = 1000 / Simulation::FRAMES_PER_SECOND;
+
+	Options                 options_;
+	std::function<void()>   onUpdate_;
+	std::unique_ptr<ITimer> timer_;
+	bool                    changed_{};
+	Versus                  versus_;
+	HeuristicEvaluator      evaluator_{ HeuristicEvaluator::Weights::startup() };
+	std::vector<Opponent>   opponents_{}; // on the boards after the first
+	Clock::time_point       started_{};
+
+	// Steps the match frame by frame up to the wall clock, with the opponents making their inputs on the way.
+	void catchUp()
+	{
+		const auto elapsed = std::chrono::duration<double>(Clock::now() - this->started_).count();
+		const auto frame   = static_cast<uint64_t>(elapsed * Simulation::FRAMES_PER_SECOND);
+		while (this->versus_.frame() < frame)
+		{
+			this->versus_.advanceTo(this->versus_.frame() + 1);
+			for (size_t i = 0; i < this->opponents_.size(); ++i)
+			{
+				if (const auto input = this->opponents_[i].act(this->versus_.state(i + 1)))
+				{
+					this->versus_.processInputEvent(i + 1, *input);
+				}
+			}
+		}
+	}
+
+	void notify()
+	{
+		if (this->changed_)
+		{
+			this->changed_ = false;
+			this->onUpdate_();
+		}
+	}
+
+	void tick()
+	{
+		this->catchUp();
+		this->notify();
+		if (!this->versus_.over())
+		{
+			this->timer_->start(TICK_MSEC, [this]() { this->tick(); });
+		}
+	}
+
+public:
+	impl(const Options& options, std::function<void()> onUpdate, std::unique_ptr<ITimer> timer)
+	    : options_{ options }
+	    , onUpdate_{ std::move(onUpdate) }
+	    , timer_{ std::move(timer) }
+	    , versus_{ options.boards, options.versus, [this]() { this->changed_ = true; } }
+	{
+	}
+
+	~impl() noexcept
+	{
+		this->timer_->stop();
+	}
+
+	void start()
+	{
+		this->timer_->stop();
+		const auto seed = BagOfSeven::randomSeed();
+		this->versus_.start(seed);
+		this->opponents_.clear();
+		for (size_t i = 1; i < this->options_.boards; ++i)
+		{
+			auto search = std::make_unique<BeamSearch>(this->evaluator_, BeamSearch::Options{});
+			this->opponents_.emplace_back(std::move(search), this->options_.pace, seed + i);
+		}
+		this->started_ = Clock::now();
+		this->changed_ = true;
+		this->tick();
+	}
+
+	const Versus& versus() const
+	{
+		return this->versus_;
+	}
+
+	void processInputEvent(InputEvent event)
+	{
+		if (event == InputEvent::NEW_GAME)
+		{
+			return this->start();
+		}
+		this->catchUp();
+		this->versus_.processInputEvent(0, event);
+		this->notify();
+	}
+};
+
+VersusGame::VersusGame(const Options& options, std::function<void()> onUpdate, std::unique_ptr<ITimer> timer)
+    : pimpl_{ std::make_unique<impl>(options, std::move(onUpdate), std::move(timer)) }
+{
+}
+
+VersusGame::~VersusGame() noexcept
+{
+}
+
+void VersusGame::start()
+{
+	return this->pimpl_->start();
+}
+
+size_t VersusGame::boards() const
+{
+	return this->pimpl_->versus().size();
+}
+
+const Board& VersusGame::board(size_t board) const
+{
+	return this->pimpl_->versus().board(board);
+}
+
+void VersusGame::processInputEvent(InputEvent event)
+{
+	return this->pimpl_->processInputEvent(event);
+}
+
+} // namespace ai
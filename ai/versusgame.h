@@ -0,0 +1,43 @@
+#pragma once
+
+#include "versus.h"
+
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+class Board;
+class ITimer;
+enum class InputEvent;
+
+namespace ai {
+
+// A versus match in real time: the player on the first board against AI opponents on the others. One timer brings the
+// whole match up to the wall clock every frame, and the renderer hears of it once per tick at most, however many boards
+// changed during it.
+class VersusGame final
+{
+	class impl;
+	std::unique_ptr<impl> pimpl_;
+
+public:
+	struct Options final
+	{
+		size_t          boards = 2;
+		Versus::Options versus{};
+		int             pace = 6; // frames between the inputs of an opponent
+	};
+
+	VersusGame(const Options& options, std::function<void()> onUpdate, std::unique_ptr<ITimer> timer);
+	~VersusGame() noexcept;
+
+	void start();
+
+	size_t       boards() const;
+	const Board& board(size_t board) const;
+
+	// Plays the input on the player's board. NEW_GAME starts a new match.
+	void processInputEvent(InputEvent event);
+};
+
+} // namespace ai
@@ -0,0 +1,177 @@
+#include "weighttuner.h"
+#include "aiplayer.h"
+#include "beamsearch.h"
+#include "batchrunner.h"
+#include "threadpool.h"
+#include "xoshiro256.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace ai {
+
+namespace {
+
+CmaEs::Vector vector_of(const HeuristicEvaluator::Weights& weights)
+{
+	CmaEs::Vector vector{};
+	for (const auto& field : HeuristicEvaluator::Weights::fields())
+	{
+		vector.push_back(weights.*field.second);
+	}
+	return vector;
+}
+
+HeuristicEvaluator::Weights weights_of(const CmaEs::Vector& vector)
+{
+	HeuristicEvaluator::Weights weights{};
+	const auto&                 fields = HeuristicEvaluator::Weights::fields();
+	for (size_t i = 0; i < fields.size(); ++i)
+	{
+		weights.*fields[i].second = vector[i];
+	}
+	return weights;
+}
+
+constexpr auto FORMAT = "tune 1";
+
+// The options of the run, then the CMA-ES state.
+std::pair<WeightTuner::Options, CmaEs> load(const std::string& checkpoint)
+{
+	std::ifstream in{ checkpoint };
+	if (!in)
+	{
+		throw std::runtime_error{ "cannot read checkpoint: " + checkpoint };
+	}
+
+	std::string format{};
+	std::getline(in, format);
+	if (format != FORMAT)
+	{
+		throw std::runtime_error{ "not a checkpoint of tune: " + checkpoint };
+	}
+	WeightTuner::Options options{};
+	std::string          population{}, games{}, maxPieces{}, depth{}, sigma{}, seed{};
+	in >> population >> options.population >> games >> options.games >> maxPieces >> options.maxPieces >> depth >> options.depth
+	    >> sigma >> options.sigma >> seed >> options.seed;
+	if (!in || population != "population" || games != "games" || maxPieces != "maxPieces" || depth != "depth" || sigma != "sigma"
+	    || seed != "seed")
+	{
+		throw std::runtime_error{ "checkpoint: expected the options of the run: " + checkpoint };
+	}
+	in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+	auto cmaes = CmaEs::load(in);
+	if (cmaes.mean().size() != HeuristicEvaluator::Weights::fields().size())
+	{
+		throw std::runtime_error{ "the checkpoint is not of heuristic weights: " + checkpoint };
+	}
+	return { options, std::move(cmaes) };
+}
+
+} // namespace
+
+WeightTuner::WeightTuner(ThreadPool& pool, const Options& options, const HeuristicEvaluator::Weights& start)
+    : pool_{ pool }
+    , options_{ options }
+    , cmaes_{ vector_of(start), options.sigma, options.population, options.seed }
+{
+}
+
+WeightTuner::WeightTuner(ThreadPool& pool, const std::string& checkpoint)
+    : WeightTuner{ pool, load(checkpoint) }
+{
+}
+
+WeightTuner::WeightTuner(ThreadPool& pool, std::pair<Options, CmaEs>&& run)
+    : pool_{ pool }
+    , options_{ run.first }
+    , cmaes_{ std::move(run.second) }
+{
+}
+
+const WeightTuner::Options& WeightTuner::options() const
+{
+	return this->options_;
+}
+
+HeuristicEvaluator::Weights WeightTuner::weights() const
+{
+	return weights_of(this->cmaes_.mean());
+}
+
+uint64_t WeightTuner::generation() const
+{
+	return this->cmaes_.generation();
+}
+
+WeightTuner::Generation WeightTuner::step()
+{
+	const auto& candidates = this->cmaes_.ask();
+	const auto  games      = this->options_.games;
+	const auto  seed       = Xoshiro256{ this->options_.seed + this->cmaes_.generation() }();
+
+	auto searchOptions  = BeamSearch::Options{};
+	searchOptions.depth = this->options_.depth;
+
+	// One job per game of every candidate, so that even a small population keeps a large machine busy.
+	std::vector<uint32_t> lines(candidates.size() * games);
+	this->pool_.parallelFor(lines.size(), [&](size_t job) {
+		const auto evaluator = HeuristicEvaluator{ weights_of(candidates[job / games]) };
+		auto       player    = AiPlayer{ std::make_unique<BeamSearch>(evaluator, searchOptions) };
+		lines[job]           = BatchRunner::play(player, BatchRunner::gameSeed(seed, job % games), this->options_.maxPieces).lines;
+	});
+
+	// CMA-ES minimizes.
+	std::vector<double> values(candidates.size());
+	for (size_t candidate = 0; candidate < candidates.size(); ++candidate)
+	{
+		const auto first  = lines.begin() + static_cast<std::ptrdiff_t>(candidate * games);
+		values[candidate] = -std::accumulate(first, first + static_cast<std::ptrdiff_t>(games), 0.0) / static_cast<double>(games);
+	}
+
+	const auto best       = static_cast<size_t>(std::min_element(values.begin(), values.end()) - values.begin());
+	auto       generation = Generation{};
+	generation.number     = this->cmaes_.generation();
+	generation.bestLines  = -values[best];
+	generation.meanLines  = -std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+	generation.best       = weights_of(candidates[best]);
+
+	this->cmaes_.tell(values);
+	generation.sigma = this->cmaes_.sigma();
+	return generation;
+}
+
+void WeightTuner::save(const std::string& checkpoint) const
+{
+	const auto temporary = checkpoint + ".tmp";
+	{
+		std::ofstream out{ temporary, std::ios::trunc };
+		out.precision(17);
+		out << FORMAT << '\n';
+		out << "population " << this->options_.population << '\n';
+		out << "games " << this->options_.games << '\n';
+		out << "maxPieces " << this->options_.maxPieces << '\n';
+		out << "depth " << this->options_.depth << '\n';
+		out << "sigma " << this->options_.sigma << '\n';
+		out << "seed " << this->options_.seed << '\n';
+		this->cmaes_.save(out);
+		out.flush();
+		if (!out)
+		{
+			throw std::runtime_error{ "cannot write checkpoint: " + temporary };
+		}
+	}
+	if (std::rename(temporary.c_str(), checkpoint.c_str()) != 0)
+	{
+		throw std::runtime_error{ "cannot replace checkpoint: " + checkpoint };
+	}
+}
+
+} // namespace ai
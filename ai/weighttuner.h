@@ -0,0 +1,69 @@
+#pragma once
+
+#include "cmaes.h"
+#include "heuristicevaluator.h"
+
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+namespace ai {
+
+// Tunes the heuristic weights with CMA-ES. A candidate's fitness is the mean number of lines it clears in seeded headless
+// games. All candidates of a generation play the same seeds, which differ from generation to generation, and all their
+// games run at once on the thread pool.
+class WeightTuner final
+{
+public:
+	struct Options final
+	{
+		size_t   population = 0;  // 0 for the CMA-ES default
+		size_t   games      = 32; // per candidate
+		uint32_t maxPieces  = 1000;
+		int      depth      = 1; // tetrominoes the beam search playing the games looks ahead
+		double   sigma      = 0.3;
+		uint64_t seed       = 1;
+	};
+
+	struct Generation final
+	{
+		uint64_t                    number;
+		double                      bestLines; // mean over the games of the best candidate
+		double                      meanLines; // mean over all candidates
+		HeuristicEvaluator::Weights best;
+		double                      sigma;
+	};
+
+private:
+	ThreadPool& pool_;
+	Options     options_;
+	CmaEs       cmaes_;
+
+	WeightTuner(ThreadPool& pool, std::pair<Options, CmaEs>&& run);
+
+public:
+	WeightTuner(ThreadPool& pool, const Options& options, const HeuristicEvaluator::Weights& start);
+
+	// Continues the run saved in a checkpoint, with the options it was started with, so that it plays the same games as
+	// a run that was never stopped. Throws std::runtime_error when it cannot be read.
+	WeightTuner(ThreadPool& pool, const std::string& checkpoint);
+
+	const Options& options() const;
+
+	// The weights the search is centred on, the best estimate so far.
+	HeuristicEvaluator::Weights weights() const;
+
+	uint64_t generation() const;
+
+	// Plays the games of one generation and updates the search.
+	Generation step();
+
+	// The options and the CMA-ES state. Written to a temporary file first and renamed, so an interrupted save leaves the
+	// previous checkpoint intact.
+	void save(const std::string& checkpoint) const;
+};
+
+} // namespace ai
@@ -0,0 +1,122 @@
+#include "allocationcheck.h"
+#include "batchrunner.h"
+#include "randomplayer.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+std::atomic<uint64_t> allocations{};
+
+void* allocate(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (const auto p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+void* allocate(size_t size, std::align_val_t alignment)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	const auto align = static_cast<size_t>(alignment);
+	// aligned_alloc wants a multiple of the alignment.
+	const auto rounded = (std::max<size_t>(size, 1) + align - 1) / align * align;
+#ifdef _WIN32
+	const auto p = _aligned_malloc(rounded, align);
+#else
+	const auto p = std::aligned_alloc(align, rounded);
+#endif
+	if (p)
+	{
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+void deallocate(void* p, std::align_val_t)
+{
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+} // namespace
+
+// The nothrow and array forms default to these.
+void* operator new(size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return allocate(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+	deallocate(p, alignment);
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept
+{
+	deallocate(p, alignment);
+}
+
+std::string AllocationReport::summary() const
+{
+	return fmt::format("{} tetrominoes in {} games: {} allocations in the first game, {} after it\n",
+	                   this->pieces,
+	                   this->games,
+	                   this->warmUp,
+	                   this->steady);
+}
+
+uint64_t AllocationCheck::allocations()
+{
+	return ::allocations.load(std::memory_order_relaxed);
+}
+
+AllocationReport AllocationCheck::run(uint64_t pieces, uint64_t seed)
+{
+	AllocationReport report{};
+	RandomPlayer     player{ seed };
+
+	const auto started = allocations();
+	auto       warm    = started;
+	for (; report.pieces < pieces; ++report.games)
+	{
+		report.pieces += BatchRunner::play(player, BatchRunner::gameSeed(seed, report.games), 0).pieces;
+		if (report.games == 0)
+		{
+			warm = allocations();
+		}
+	}
+	report.warmUp = warm - started;
+	report.steady = allocations() - warm;
+	return report;
+}
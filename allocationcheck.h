@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+struct AllocationReport final
+{
+	uint64_t games;
+	uint64_t pieces;
+	uint64_t warmUp; // allocations during the first game
+	uint64_t steady; // allocations during the games after it, which should make none
+
+	std::string summary() const;
+};
+
+// Checks that a game in progress does not allocate. The program replaces the global operator new with one that counts its
+// calls (in allocationcheck.cpp), which costs a relaxed atomic increment per allocation.
+class AllocationCheck final
+{
+public:
+	// Allocations made through operator new since the program started.
+	static uint64_t allocations();
+
+	// Plays seeded headless games of the random player, which rotates, shifts and hard drops every tetromino, until they
+	// have placed the given number of tetrominoes, and counts the allocations after the first game.
+	static AllocationReport run(uint64_t pieces, uint64_t seed);
+};
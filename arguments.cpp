@@ -0,0 +1,117 @@
+#include "arguments.h"
+
+#include <fmt/format.h>
+
+#include <cctype>
+#include <stdexcept>
+
+Arguments::Arguments(int argc, char* argv[])
+{
+	if (argc > 1)
+	{
+		this->command_ = argv[1];
+	}
+	for (int i = 2; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if (arg.size() < 3 || arg.compare(0, 2, "--") != 0)
+		{
+			throw std::runtime_error{ fmt::format("unexpected argument '{}'", arg) };
+		}
+		const auto name = arg.substr(2);
+		if (i + 1 < argc && std::string{ argv[i + 1] }.compare(0, 2, "--") != 0)
+		{
+			this->options_[name] = argv[++i];
+		}
+		else
+		{
+			this->options_[name] = "";
+		}
+	}
+}
+
+Arguments::Arguments(const std::string& spec)
+{
+	size_t end     = spec.find(':');
+	this->command_ = spec.substr(0, end);
+	while (end != std::string::npos)
+	{
+		const auto begin  = end + 1;
+		end               = spec.find(':', begin);
+		const auto option = spec.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+		const auto equals = option.find('=');
+		if (option.empty() || equals == 0)
+		{
+			throw std::runtime_error{ fmt::format("unexpected option in '{}'", spec) };
+		}
+		this->options_[option.substr(0, equals)] = equals == std::string::npos ? "" : option.substr(equals + 1);
+	}
+}
+
+const std::string& Arguments::command() const
+{
+	return this->command_;
+}
+
+bool Arguments::has(const std::string& name) const
+{
+	return this->options_.find(name) != this->options_.end();
+}
+
+std::string Arguments::text(const std::string& name, const std::string& defaultValue) const
+{
+	const auto it = this->options_.find(name);
+	return it == this->options_.end() ? defaultValue : it->second;
+}
+
+uint64_t Arguments::number(const std::string& name, uint64_t defaultValue) const
+{
+	const auto it = this->options_.find(name);
+	if (it == this->options_.end())
+	{
+		return defaultValue;
+	}
+	const auto& value = it->second;
+
+	// Decimal, or hexadecimal after 0x. Only digits, as stoull would take a sign, wrap negative numbers around and stop
+	// at the first character that is not a digit, and a leading 0 is not octal.
+	const auto hex    = value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X');
+	const auto digits = hex ? value.substr(2) : value;
+	if (!digits.empty() && digits.find_first_not_of(hex ? "0123456789abcdefABCDEF" : "0123456789") == std::string::npos)
+	{
+		try
+		{
+			return std::stoull(digits, nullptr, hex ? 16 : 10);
+		}
+		catch (const std::out_of_range&)
+		{
+			// Too large, which is reported the same way.
+		}
+	}
+	throw std::runtime_error{ fmt::format("option --{} expects a number, got '{}'", name, value) };
+}
+
+double Arguments::real(const std::string& name, double defaultValue) const
+{
+	const auto it = this->options_.find(name);
+	if (it == this->options_.end())
+	{
+		return defaultValue;
+	}
+	const auto& value = it->second;
+	try
+	{
+		// stod skips leading white space and stops at the first character that does not belong to the number.
+		size_t     end{};
+		const auto number = std::stod(value, &end);
+		if (!std::isspace(static_cast<unsigned char>(value.front())) && end == value.size())
+		{
+			return number;
+		}
+	}
+	catch (const std::exception&)
+	{
+		// Not a number at all, which is reported the same way.
+	}
+	throw std::runtime_error{ fmt::format("option --{} expects a number, got '{}'", name, value) };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <cstdint>
+
+// Command line of the form: tetris <command> [--name value | --flag]...
+class Arguments final
+{
+	std::string                        command_{};
+	std::map<std::string, std::string> options_{};
+
+public:
+	Arguments(int argc, char* argv[]);
+
+	// A player spec of the form <command>[:name=value | :flag]..., such as ai:width=4:depth=1.
+	explicit Arguments(const std::string& spec);
+
+	const std::string& command() const;
+
+	bool        has(const std::string& name) const;
+	std::string text(const std::string& name, const std::string& defaultValue) const;
+	uint64_t    number(const std::string& name, uint64_t defaultValue) const;
+	double      real(const std::string& name, double defaultValue) const;
+};
@@ -1,58 +1,77 @@
 #include "bagofseven.h"
 #include "tetrominotype.h"
 
-#include <vector>
 #include <random>
-#include <algorithm>
+#include <utility>
 #include <cassert>
+#include <type_traits>
 
-class BagOfSeven::impl final
-{
-	std::vector<TetrominoType> bag_{};
-	std::random_device         rd_{};
+static_assert(std::is_trivially_copyable<BagOfSeven>::value, "");
 
-	void fill()
+void BagOfSeven::fill()
+{
+	assert(this->size_ == 0);
+	this->bag_ = { TetrominoType::J, TetrominoType::L, TetrominoType::S, TetrominoType::T,
+		           TetrominoType::Z, TetrominoType::I, TetrominoType::O };
+	this->size_ = SIZE;
+	// Fisher-Yates, spelled out so that a seed deals the same pieces with every standard library.
+	for (int i = SIZE - 1; i > 0; --i)
 	{
-		assert(this->bag_.empty());
-		this->bag_.push_back(TetrominoType::J);
-		this->bag_.push_back(TetrominoType::L);
-		this->bag_.push_back(TetrominoType::S);
-		this->bag_.push_back(TetrominoType::T);
-		this->bag_.push_back(TetrominoType::Z);
-		this->bag_.push_back(TetrominoType::I);
-		this->bag_.push_back(TetrominoType::O);
-		std::mt19937 g{ this->rd_() };
-		std::shuffle(this->bag_.begin(), this->bag_.end(), g);
+		std::swap(this->bag_[i], this->bag_[this->random_.below(i + 1)]);
 	}
+}
+
+BagOfSeven::BagOfSeven()
+    : BagOfSeven{ randomSeed() }
+{
+}
+
+BagOfSeven::BagOfSeven(uint64_t seed)
+    : random_{ seed }
+{
+	this->fill();
+}
+
+uint64_t BagOfSeven::randomSeed()
+{
+	std::random_device rd{};
+	return (uint64_t{ rd() } << 32) | rd();
+}
+
+void BagOfSeven::seed(uint64_t seed)
+{
+	this->random_.seed(seed);
+	this->size_ = 0;
+	this->fill();
+}
 
-public:
-	impl()
+TetrominoType BagOfSeven::next()
+{
+	if (this->size_ == 0)
 	{
 		this->fill();
 	}
+	return this->bag_[--this->size_];
+}
 
-	TetrominoType next()
+void BagOfSeven::reshuffle(uint64_t seed)
+{
+	this->random_.seed(seed);
+	for (int i = this->size_ - 1; i > 0; --i)
 	{
-		if (this->bag_.empty())
-		{
-			this->fill();
-		}
-		const auto result = this->bag_.back();
-		this->bag_.pop_back();
-		return result;
+		std::swap(this->bag_[i], this->bag_[this->random_.below(i + 1)]);
 	}
-};
-
-BagOfSeven::BagOfSeven()
-    : pimpl_{ std::make_unique<impl>() }
-{
 }
 
-BagOfSeven::~BagOfSeven() noexcept
+BagOfSeven::State BagOfSeven::state() const
 {
+	return State{ this->random_.state(), this->bag_, this->size_ };
 }
 
-TetrominoType BagOfSeven::next()
+void BagOfSeven::setState(const State& state)
 {
-	return this->pimpl_->next();
+	assert(state.size >= 0 && state.size <= SIZE);
+	this->random_.setState(state.random);
+	this->bag_  = state.bag;
+	this->size_ = state.size;
 }
@@ -1,17 +1,48 @@
 #pragma once
 
-#include <memory>
+#include "xoshiro256.h"
+
+#include <array>
+#include <cstdint>
 
 enum class TetrominoType;
 
+// Deals the seven tetrominoes in a random order, then the next seven, and so on. The order is fully determined by the seed,
+// and the whole dealer is a few dozen bytes that can be copied, or saved and restored through state().
 class BagOfSeven final
 {
-	class impl;
-	std::unique_ptr<impl> pimpl_;
+public:
+	static constexpr int SIZE = 7;
+
+	struct State final
+	{
+		Xoshiro256::State               random;
+		std::array<TetrominoType, SIZE> bag;
+		int                             size;
+	};
+
+private:
+	Xoshiro256                      random_;
+	std::array<TetrominoType, SIZE> bag_{};
+	int                             size_{};
+
+	void fill();
 
 public:
+	// Seeded from std::random_device.
 	BagOfSeven();
-	~BagOfSeven() noexcept;
+	explicit BagOfSeven(uint64_t seed);
+
+	static uint64_t randomSeed();
+
+	void seed(uint64_t seed);
 
 	TetrominoType next();
+
+	// Reseeds the dealer and shuffles the tetrominoes left in the current bag. Which tetrominoes are left stays the same, so
+	// this deals one of the futures a player cannot tell apart from the real one.
+	void reshuffle(uint64_t seed);
+
+	State state() const;
+	void  setState(const State& state);
 };
@@ -0,0 +1,174 @@
+#include "batchrunner.h"
+#include "iplayer.h"
+#include "replay.h"
+#include "simulation.h"
+#include "threadpool.h"
+#include "xoshiro256.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <numeric>
+
+namespace {
+
+std::string format_distribution(const char* name, const Distribution& d)
+{
+	return fmt::format("{:<8} mean {:>10.1f}  sd {:>10.1f}  min {:>8.0f}  p10 {:>8.0f}  p50 {:>8.0f}  p90 {:>8.0f}  max {:>8.0f}\n",
+	                   name,
+	                   d.mean,
+	                   d.stddev,
+	                   d.min,
+	                   d.p10,
+	                   d.p50,
+	                   d.p90,
+	                   d.max);
+}
+
+} // namespace
+
+double Distribution::percentile(const std::vector<double>& sorted, double p)
+{
+	return sorted.empty() ? 0 : sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5)];
+}
+
+Distribution Distribution::of(std::vector<double> values)
+{
+	if (values.empty())
+	{
+		return Distribution{};
+	}
+
+	std::sort(values.begin(), values.end());
+
+	const auto n        = static_cast<double>(values.size());
+	const auto mean     = std::accumulate(values.begin(), values.end(), 0.0) / n;
+	auto       variance = 0.0;
+	for (const auto value : values)
+	{
+		variance += (value - mean) * (value - mean);
+	}
+
+	return Distribution{ mean,
+		                 std::sqrt(variance / n),
+		                 values.front(),
+		                 percentile(values, 0.1),
+		                 percentile(values, 0.5),
+		                 percentile(values, 0.9),
+		                 values.back() };
+}
+
+std::string BatchReport::summary() const
+{
+	std::string result = fmt::format("{} games on {} threads in {:.3f} s\n", this->games.size(), this->threads, this->seconds);
+	result += format_distribution("lines", this->lines);
+	result += format_distribution("score", this->score);
+	result += format_distribution("level", this->level);
+	result += fmt::format("{:.1f} games/s, {:.1f} pieces/s", this->gamesPerSecond, this->piecesPerSecond);
+	if (this->rolloutsPerSecond > 0)
+	{
+		result += fmt::format(", {:.1f} rollouts/s", this->rolloutsPerSecond);
+	}
+	result += '\n';
+	return result;
+}
+
+uint64_t BatchRunner::gameSeed(uint64_t seed, size_t game)
+{
+	return Xoshiro256{ seed + game }();
+}
+
+GameResult BatchRunner::play(IPlayer& player, uint64_t seed, uint32_t maxPieces, Replay* replay)
+{
+	Simulation simulation{};
+	simulation.start(seed);
+	if (replay)
+	{
+		*replay      = Replay{};
+		replay->seed = seed;
+		simulation.record(&replay->inputs);
+	}
+
+	const auto rollouts = player.rollouts();
+
+	auto& board = simulation.board();
+	while (!board.gameOver() && (maxPieces == 0 || board.pieces() <= maxPieces))
+	{
+		const auto pieces = board.pieces();
+		player.play(simulation);
+
+		// Let gravity and the locking delay finish what the player left playing.
+		while (!board.gameOver() && board.pieces() == pieces)
+		{
+			const auto frames = simulation.framesToNextEvent();
+			if (!frames)
+			{
+				break;
+			}
+			simulation.advance(frames.value());
+		}
+	}
+
+	if (replay)
+	{
+		replay->frames = simulation.frame();
+		replay->setResults(simulation.state());
+	}
+
+	// The board counts the tetrominoes that entered, one of which is still playing when the game was cut short.
+	const auto locked = board.pieces() - (board.playingTetromino() ? 1 : 0);
+	return GameResult{ seed, locked, board.lines(), board.level(), board.score(), simulation.frame(), player.rollouts() - rollouts };
+}
+
+BatchReport BatchRunner::run(ThreadPool& pool, const Options& options, const PlayerFactory& playerFactory)
+{
+	BatchReport report{};
+	report.games.resize(options.games);
+	report.threads = pool.size();
+
+	const auto started = std::chrono::steady_clock::now();
+
+	if (!options.replays.empty())
+	{
+		std::filesystem::create_directories(options.replays);
+	}
+
+	pool.parallelFor(options.games, [&](size_t game) {
+		const auto seed   = gameSeed(options.seed, game);
+		const auto player = playerFactory(seed);
+		if (options.replays.empty())
+		{
+			report.games[game] = play(*player, seed, options.maxPieces);
+		}
+		else
+		{
+			Replay replay{};
+			report.games[game] = play(*player, seed, options.maxPieces, &replay);
+			replay.save(fmt::format("{}/{}.replay", options.replays, game), options.keyframes);
+		}
+	});
+
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+	std::vector<double> lines{}, score{}, level{};
+	uint64_t            pieces{}, rollouts{};
+	for (const auto& game : report.games)
+	{
+		lines.push_back(game.lines);
+		score.push_back(static_cast<double>(game.score));
+		level.push_back(game.level);
+		pieces += game.pieces;
+		rollouts += game.rollouts;
+	}
+	report.lines             = Distribution::of(std::move(lines));
+	report.score             = Distribution::of(std::move(score));
+	report.level             = Distribution::of(std::move(level));
+	report.gamesPerSecond    = report.seconds > 0 ? report.games.size() / report.seconds : 0;
+	report.piecesPerSecond   = report.seconds > 0 ? pieces / report.seconds : 0;
+	report.rolloutsPerSecond = report.seconds > 0 ? rollouts / report.seconds : 0;
+
+	return report;
+}
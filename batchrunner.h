@@ -0,0 +1,74 @@
+#pragma once
+
+#include "replay.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class IPlayer;
+class ThreadPool;
+
+struct GameResult final
+{
+	uint64_t seed;
+	uint32_t pieces; // locked
+	uint32_t lines;
+	uint32_t level;
+	uint64_t score;
+	uint64_t frames;
+	uint64_t rollouts; // games the player played out to decide its moves
+};
+
+struct Distribution final
+{
+	double mean, stddev;
+	double min, p10, p50, p90, max;
+
+	static Distribution of(std::vector<double> values);
+
+	// The value at the share p of the sorted values, nearest rank, 0 for none.
+	static double percentile(const std::vector<double>& sorted, double p);
+};
+
+struct BatchReport final
+{
+	std::vector<GameResult> games;
+	Distribution            lines;
+	Distribution            score;
+	Distribution            level;
+	unsigned                threads;
+	double                  seconds;
+	double                  gamesPerSecond;
+	double                  piecesPerSecond;
+	double                  rolloutsPerSecond;
+
+	std::string summary() const;
+};
+
+// Plays many independent headless games in parallel. Game i is seeded from the base seed and i, so a batch is reproducible
+// however its games are spread over the threads.
+class BatchRunner final
+{
+public:
+	using PlayerFactory = std::function<std::unique_ptr<IPlayer>(uint64_t seed)>;
+
+	struct Options final
+	{
+		size_t      games     = 1000;
+		uint64_t    seed      = 1;
+		uint32_t    maxPieces = 0; // stop a game after this many tetrominoes, 0 for no limit
+		std::string replays{};     // a directory to save the replay of every game to, as <game>.replay
+		// Frames between the keyframes of the replays.
+		uint64_t keyframes = Replay::DEFAULT_KEYFRAME_SPACING;
+	};
+
+	static uint64_t gameSeed(uint64_t seed, size_t game);
+
+	// Records the game into the replay, when there is one.
+	static GameResult play(IPlayer& player, uint64_t seed, uint32_t maxPieces, Replay* replay = nullptr);
+
+	static BatchReport run(ThreadPool& pool, const Options& options, const PlayerFactory& playerFactory);
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+// Bit counting helpers for the bitboards. C++17 has no <bit>, so use the compiler builtins where there are any.
+
+inline int popcount(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcount(x);
+#else
+	int count{};
+	for (; x; x &= x - 1)
+	{
+		++count;
+	}
+	return count;
+#endif
+}
+
+// Named apart from popcount(), so that narrower arguments do not make the call ambiguous.
+inline int popcount64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(x);
+#else
+	return popcount(static_cast<uint32_t>(x)) + popcount(static_cast<uint32_t>(x >> 32));
+#endif
+}
+
+// Index of the lowest set bit. x must not be 0.
+inline int countr_zero(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(x);
+#else
+	int count{};
+	for (; !(x & 1); x >>= 1)
+	{
+		++count;
+	}
+	return count;
+#endif
+}
+
+// AVX2 kernels are compiled with a function target attribute and picked at run time with cpu_has_avx2(), so the build needs
+// no extra flags and the program still runs on processors without AVX2.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_AVX2_KERNELS
+#define AVX2_KERNEL __attribute__((target("avx2")))
+
+inline bool cpu_has_avx2()
+{
+	static const bool has = __builtin_cpu_supports("avx2");
+	return has;
+}
+#endif
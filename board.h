@@ -1,21 +1,32 @@
 #pragma once
 
-#include <memory>
-#include <cstdint>
+#include "grid.h"
+#include "tetromino.h"
+#include "playingtetromino.h"
 
-class Grid;
-class PlayingTetromino;
-class Tetromino;
-enum class TetrominoType;
+#include <optional>
+#include <cstdint>
 
+// Holds all of its state inline, so a board never allocates and copying one copies the whole game position.
 class Board final
 {
-	class impl;
-	std::unique_ptr<impl> pimpl_;
+	Grid                            grid_{};
+	std::optional<PlayingTetromino> playingTetromino_{};
+	Tetromino                       nextTetromino_;
+	uint32_t                        pieces_{ 0 };
+	uint32_t                        level_{ 0 };
+	uint32_t                        lines_{ 0 };
+	uint64_t                        score_{ 0 };
+	bool                            gameOver_{};
 
 public:
 	explicit Board(TetrominoType nextType);
-	~Board() noexcept;
+
+	// Where new tetrominoes enter the grid, in their initial rotation.
+	static constexpr GridPosition initialTetrominoPosition()
+	{
+		return GridPosition{ 1, (Grid::width() - 4) / 2 };
+	}
 
 	Grid&       grid();
 	const Grid& grid() const;
@@ -26,8 +37,14 @@ public:
 	Tetromino&       nextTetromino();
 	const Tetromino& nextTetromino() const;
 
+	// Grid cell with the playing tetromino overlaid on it.
+	std::optional<TetrominoColor> cell(int row, int column) const;
+
 	bool moveNextTetrominoToGrid(TetrominoType nextType);
+	void lockPlayingTetromino();
 
+	// Number of tetrominoes that have entered the grid.
+	uint32_t pieces() const;
 	uint32_t level() const;
 	uint32_t lines() const;
 	uint64_t score() const;
@@ -38,4 +55,8 @@ public:
 	void setScore(uint64_t score);
 	void addScore(uint64_t score);
 	void setGameOver();
+
+	// For restoring a saved board.
+	void setPieces(uint32_t pieces);
+	void setPlayingTetromino(const std::optional<PlayingTetromino>& playingTetromino);
 };
@@ -0,0 +1,300 @@
+#include "botprocess.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+// A pipe whose ends are closed on exec, so that no bot, nor anything else the game starts, holds the pipes of another
+// bot open. Where there is no pipe2, a fork on another thread between the pipe and the fcntl may still leak them.
+bool make_pipe(int ends[2])
+{
+#ifdef __linux__
+	return pipe2(ends, O_CLOEXEC) == 0;
+#else
+	if (pipe(ends) != 0)
+	{
+		return false;
+	}
+	fcntl(ends[0], F_SETFD, FD_CLOEXEC);
+	fcntl(ends[1], F_SETFD, FD_CLOEXEC);
+	return true;
+#endif
+}
+
+// Puts the end of a pipe on a standard descriptor of the bot, leaving it open across the exec. A dup2 onto itself would
+// keep close-on-exec, as happens when the game was started with that descriptor closed.
+void redirect(int end, int descriptor)
+{
+	if (end == descriptor)
+	{
+		fcntl(descriptor, F_SETFD, 0);
+	}
+	else
+	{
+		dup2(end, descriptor);
+	}
+}
+
+void close_pipe(const int ends[2])
+{
+	close(ends[0]);
+	close(ends[1]);
+}
+
+} // namespace
+#endif
+
+class BotProcess::impl final
+{
+	int                         in_{ -1 }, out_{ -1 };
+	int                         pid_{ -1 };
+	std::unique_ptr<BotChannel> channel_{};
+	std::string                 name_{};
+	std::atomic<uint32_t>       nextId_{ 1 };
+
+	std::mutex writing_{};
+
+	// The answers that arrived for requests that are still waiting. Whichever waiting thread finds nobody reading reads
+	// the next message for all, so there is no reader thread to hand the answers over from.
+	std::mutex                               mutex_{};
+	std::condition_variable                  arrived_{};
+	std::unordered_map<uint32_t, BotMessage> answers_{};
+	bool                                     reading_{};
+	bool                                     closed_{};
+
+	void start(const std::string& command);
+	void stop() noexcept;
+
+public:
+	explicit impl(const std::string& command)
+	{
+		this->start(command);
+		try
+		{
+			BotMessage info{ BotMessage::Type::INFO };
+			if (!this->channel_->receive(info) || info.type != BotMessage::Type::INFO)
+			{
+				throw std::runtime_error{ fmt::format("the bot did not introduce itself: {}", command) };
+			}
+			if (info.version != BotMessage::VERSION)
+			{
+				throw std::runtime_error{ fmt::format("the bot speaks protocol version {}, not {}", info.version, BotMessage::VERSION) };
+			}
+			this->name_ = info.name;
+		}
+		catch (const std::exception&)
+		{
+			this->stop();
+			throw;
+		}
+	}
+
+	~impl() noexcept
+	{
+		this->stop();
+	}
+
+	const std::string& name() const
+	{
+		return this->name_;
+	}
+
+	// The first of count consecutive ids.
+	uint32_t newIds(uint32_t count)
+	{
+		return this->nextId_.fetch_add(count);
+	}
+
+	void send(const BotMessage& message, bool flush)
+	{
+		std::lock_guard<std::mutex> lock{ this->writing_ };
+		this->channel_->send(message);
+		if (flush)
+		{
+			this->channel_->flush();
+		}
+	}
+
+	BotMessage await(uint32_t id)
+	{
+		std::unique_lock<std::mutex> lock{ this->mutex_ };
+		for (;;)
+		{
+			const auto it = this->answers_.find(id);
+			if (it != this->answers_.end())
+			{
+				auto answer = std::move(it->second);
+				this->answers_.erase(it);
+				return answer;
+			}
+			if (this->closed_)
+			{
+				throw std::runtime_error{ fmt::format("the bot {} exited", this->name_) };
+			}
+			if (this->reading_)
+			{
+				this->arrived_.wait(lock);
+				continue;
+			}
+
+			this->reading_ = true;
+			lock.unlock();
+			BotMessage message{};
+			bool       received{};
+			try
+			{
+				received = this->channel_->receive(message);
+				if (received && message.type == BotMessage::Type::PING)
+				{
+					this->send(BotMessage{ BotMessage::Type::PONG, message.id }, true);
+				}
+			}
+			catch (const std::exception&)
+			{
+				lock.lock();
+				this->reading_ = false;
+				this->closed_  = true;
+				this->arrived_.notify_all();
+				throw;
+			}
+			lock.lock();
+			this->reading_ = false;
+			this->closed_  = !received;
+			if (received && (message.type == BotMessage::Type::SUGGESTION || message.type == BotMessage::Type::PONG))
+			{
+				this->answers_[message.id] = std::move(message);
+			}
+			this->arrived_.notify_all();
+		}
+	}
+};
+
+void BotProcess::impl::start(const std::string& command)
+{
+#ifdef _WIN32
+	(void)command;
+	throw std::runtime_error{ "external bots need POSIX pipes" };
+#else
+	// A bot that exits while it is written to must not take the game down with it.
+	std::signal(SIGPIPE, SIG_IGN);
+
+	int toBot[2], fromBot[2];
+	if (!make_pipe(toBot))
+	{
+		throw std::runtime_error{ "cannot create the pipes to the bot" };
+	}
+	if (!make_pipe(fromBot))
+	{
+		close_pipe(toBot);
+		throw std::runtime_error{ "cannot create the pipes to the bot" };
+	}
+	this->pid_ = fork();
+	if (this->pid_ < 0)
+	{
+		close_pipe(toBot);
+		close_pipe(fromBot);
+		throw std::runtime_error{ "cannot start the bot" };
+	}
+	if (this->pid_ == 0)
+	{
+		// The exec closes the ends that are not redirected.
+		redirect(toBot[0], STDIN_FILENO);
+		redirect(fromBot[1], STDOUT_FILENO);
+		execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+		_exit(127);
+	}
+	close(toBot[0]);
+	close(fromBot[1]);
+	this->out_ = toBot[1];
+	this->in_  = fromBot[0];
+
+	this->channel_ = std::make_unique<BotChannel>(this->in_, this->out_);
+#endif
+}
+
+void BotProcess::impl::stop() noexcept
+{
+#ifndef _WIN32
+	try
+	{
+		std::lock_guard<std::mutex> lock{ this->writing_ };
+		this->channel_->send(BotMessage{ BotMessage::Type::QUIT });
+		this->channel_->flush();
+	}
+	catch (const std::exception&)
+	{
+		// The bot is gone already.
+	}
+	close(this->out_);
+	close(this->in_);
+	waitpid(this->pid_, nullptr, 0);
+#endif
+}
+
+BotProcess::BotProcess(const std::string& command)
+    : pimpl_{ std::make_unique<impl>(command) }
+{
+}
+
+BotProcess::~BotProcess() noexcept
+{
+}
+
+const std::string& BotProcess::name() const
+{
+	return this->pimpl_->name();
+}
+
+BotProcess::Suggestion BotProcess::suggest(const BotState& state)
+{
+	BotMessage request{ BotMessage::Type::SUGGEST };
+	request.id    = this->pimpl_->newIds(1);
+	request.state = state;
+	this->pimpl_->send(request, true);
+	return Suggestion{ request.id, this->pimpl_->await(request.id).moves };
+}
+
+void BotProcess::play(uint32_t id, uint8_t played)
+{
+	BotMessage message{ BotMessage::Type::PLAY };
+	message.id     = id;
+	message.played = played;
+	this->pimpl_->send(message, false);
+}
+
+void BotProcess::ping(size_t count)
+{
+	// In windows of CHUNK, the next sent before waiting for the answers to the last, so that the bot always has pings to
+	// answer, but neither side writes so much ahead that the pipe fills up while the other is writing too.
+	constexpr size_t CHUNK = 256;
+
+	const auto first = this->pimpl_->newIds(static_cast<uint32_t>(count));
+	for (size_t chunk = 0; chunk < count + CHUNK; chunk += CHUNK)
+	{
+		for (size_t i = chunk; i < std::min(chunk + CHUNK, count); ++i)
+		{
+			BotMessage message{ BotMessage::Type::PING };
+			message.id = first + static_cast<uint32_t>(i);
+			this->pimpl_->send(message, i + 1 == std::min(chunk + CHUNK, count));
+		}
+		for (size_t i = chunk - std::min(chunk, CHUNK); i < std::min(chunk, count); ++i)
+		{
+			this->pimpl_->await(first + static_cast<uint32_t>(i));
+		}
+	}
+}
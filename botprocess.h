@@ -0,0 +1,41 @@
+#pragma once
+
+#include "botprotocol.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// A bot running as a child process, started through the shell, that speaks the protocol of botprotocol.h. Any number of
+// threads may ask it for moves at once: each request is written as soon as it is made, and the answers are matched to
+// the requests by id, so the bot always has the next request waiting while it thinks. Throws std::runtime_error when the
+// bot cannot be started, breaks the protocol or exits.
+class BotProcess final
+{
+	class impl;
+	std::unique_ptr<impl> pimpl_;
+
+public:
+	struct Suggestion final
+	{
+		uint32_t             id;
+		std::vector<BotMove> moves;
+	};
+
+	// Starts the bot and waits for its INFO.
+	explicit BotProcess(const std::string& command);
+	// Asks the bot to quit, and waits for it.
+	~BotProcess() noexcept;
+
+	const std::string& name() const;
+
+	Suggestion suggest(const BotState& state);
+
+	// Tells the bot which of the moves of a suggestion was played, BotMessage::NONE for none. Goes out with the next request.
+	void play(uint32_t id, uint8_t played);
+
+	// Sends the given number of pings without waiting for the answers in between, and returns once all are answered.
+	void ping(size_t count = 1);
+};
@@ -0,0 +1,404 @@
+#include "botprotocol.h"
+#include "gamestate.h"
+#include "inputevent.h"
+
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#define read _read
+#define write _write
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t   HEADER    = 4;       // the frame length
+constexpr uint32_t MAX_FRAME = 1 << 20; // far more than any message needs, so a garbled length is caught
+constexpr size_t   READ_SIZE = 1 << 16;
+
+constexpr int TETROMINO_TYPES = 7;
+constexpr int INPUT_EVENTS    = static_cast<int>(InputEvent::NEW_GAME);
+
+void put(std::vector<uint8_t>& out, uint32_t value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+}
+
+// Reads a payload, checking that it is long enough and that its values are in range.
+class Reader final
+{
+	const uint8_t* data_;
+	size_t         size_;
+	size_t         position_{};
+
+	uint32_t get(int bytes)
+	{
+		if (this->size_ - this->position_ < static_cast<size_t>(bytes))
+		{
+			throw std::runtime_error{ "bot protocol: message too short" };
+		}
+		uint32_t value{};
+		for (int i = 0; i < bytes; ++i)
+		{
+			value |= uint32_t{ this->data_[this->position_++] } << (8 * i);
+		}
+		return value;
+	}
+
+public:
+	Reader(const uint8_t* data, size_t size)
+	    : data_{ data }
+	    , size_{ size }
+	{
+	}
+
+	uint8_t u8()
+	{
+		return static_cast<uint8_t>(this->get(1));
+	}
+
+	uint16_t u16()
+	{
+		return static_cast<uint16_t>(this->get(2));
+	}
+
+	uint32_t u32()
+	{
+		return this->get(4);
+	}
+
+	int i8()
+	{
+		return static_cast<int8_t>(this->get(1));
+	}
+
+	int below(int bound, const char* what)
+	{
+		const auto value = this->u8();
+		if (value >= bound)
+		{
+			throw std::runtime_error{ fmt::format("bot protocol: {} {} out of range", what, value) };
+		}
+		return value;
+	}
+
+	std::string rest()
+	{
+		std::string text{ reinterpret_cast<const char*>(this->data_ + this->position_), this->size_ - this->position_ };
+		this->position_ = this->size_;
+		return text;
+	}
+};
+
+void put_state(std::vector<uint8_t>& out, const BotState& state)
+{
+	for (const auto row : state.rows)
+	{
+		put(out, row, 2);
+	}
+	put(out, static_cast<uint32_t>(state.current), 1);
+	put(out, static_cast<uint32_t>(state.rotation), 1);
+	put(out, static_cast<uint32_t>(state.row), 1);
+	put(out, static_cast<uint32_t>(state.column), 1);
+	put(out, static_cast<uint32_t>(state.next), 1);
+	put(out, state.bag, 1);
+	put(out, state.pieces, 4);
+}
+
+BotState get_state(Reader& in)
+{
+	BotState state{};
+	for (auto& row : state.rows)
+	{
+		row = in.u16();
+	}
+	state.current  = static_cast<TetrominoType>(in.below(TETROMINO_TYPES, "tetromino"));
+	state.rotation = in.below(4, "rotation");
+	state.row      = in.i8();
+	state.column   = in.i8();
+	state.next     = static_cast<TetrominoType>(in.below(TETROMINO_TYPES, "tetromino"));
+	state.bag      = in.u8();
+	state.pieces   = in.u32();
+	return state;
+}
+
+void put_move(std::vector<uint8_t>& out, const BotMove& move)
+{
+	put(out, static_cast<uint32_t>(move.kind), 1);
+	if (move.kind == BotMove::Kind::PLACEMENT)
+	{
+		put(out, static_cast<uint32_t>(move.rotation), 1);
+		put(out, static_cast<uint32_t>(move.row), 1);
+		put(out, static_cast<uint32_t>(move.column), 1);
+	}
+	else
+	{
+		put(out, static_cast<uint32_t>(move.inputs.size()), 1);
+		for (const auto input : move.inputs)
+		{
+			put(out, static_cast<uint32_t>(input), 1);
+		}
+	}
+}
+
+BotMove get_move(Reader& in)
+{
+	BotMove move{};
+	move.kind = static_cast<BotMove::Kind>(in.below(2, "move kind"));
+	if (move.kind == BotMove::Kind::PLACEMENT)
+	{
+		move.rotation = in.below(4, "rotation");
+		move.row      = in.i8();
+		move.column   = in.i8();
+	}
+	else
+	{
+		move.inputs.resize(in.u8());
+		for (auto& input : move.inputs)
+		{
+			input = static_cast<InputEvent>(in.below(INPUT_EVENTS, "input"));
+		}
+	}
+	return move;
+}
+
+} // namespace
+
+BotState BotState::of(const GameState& state)
+{
+	const auto& board   = *state.board;
+	const auto& playing = *board.playingTetromino();
+
+	BotState result{};
+	result.rows     = board.grid().bitboard();
+	result.current  = playing.tetromino().type();
+	result.rotation = playing.tetromino().rotation();
+	result.row      = playing.position().row;
+	result.column   = playing.position().column;
+	result.next     = board.nextTetromino().type();
+	result.pieces   = board.pieces();
+
+	// An empty bag is refilled with all seven before the next draw.
+	const auto bag = state.bagOfSeven.state();
+	result.bag     = bag.size == 0 ? (1u << TETROMINO_TYPES) - 1 : 0;
+	for (int i = 0; i < bag.size; ++i)
+	{
+		result.bag |= 1u << static_cast<int>(bag.bag[i]);
+	}
+	return result;
+}
+
+GameState BotState::gameState() const
+{
+	GameState state{};
+	auto&     board = state.board.emplace(this->current);
+	for (int row = 0; row < Grid::height(); ++row)
+	{
+		for (int column = 0; column < Grid::width(); ++column)
+		{
+			if (this->rows[row] >> column & 1)
+			{
+				board.grid().setCell(row, column, Tetromino::color(TetrominoType::O));
+			}
+		}
+	}
+	if (board.moveNextTetrominoToGrid(this->next))
+	{
+		*board.playingTetromino() = PlayingTetromino{ Tetromino{ this->current, this->rotation }, GridPosition{ this->row, this->column } };
+	}
+	else
+	{
+		board.setGameOver();
+	}
+
+	auto bag = BagOfSeven::State{ Xoshiro256{ this->pieces }.state(), {}, 0 };
+	for (int type = 0; type < TETROMINO_TYPES; ++type)
+	{
+		if (this->bag >> type & 1)
+		{
+			bag.bag[bag.size++] = static_cast<TetrominoType>(type);
+		}
+	}
+	state.bagOfSeven.setState(bag);
+	state.seed = this->pieces;
+	return state;
+}
+
+BotChannel::BotChannel(int in, int out)
+    : in_{ in }
+    , out_{ out }
+    , input_(READ_SIZE)
+{
+}
+
+void BotChannel::send(const BotMessage& message)
+{
+	auto&      out   = this->output_;
+	const auto start = out.size();
+	put(out, 0, HEADER);
+	put(out, static_cast<uint32_t>(message.type), 1);
+	put(out, message.id, 4);
+
+	switch (message.type)
+	{
+	case BotMessage::Type::INFO:
+		put(out, message.version, 2);
+		out.insert(out.end(), message.name.begin(), message.name.end());
+		break;
+	case BotMessage::Type::SUGGEST:
+		put_state(out, message.state);
+		break;
+	case BotMessage::Type::SUGGESTION:
+		put(out, static_cast<uint32_t>(message.moves.size()), 1);
+		for (const auto& move : message.moves)
+		{
+			put_move(out, move);
+		}
+		break;
+	case BotMessage::Type::PLAY:
+		put(out, message.played, 1);
+		break;
+	case BotMessage::Type::PING:
+	case BotMessage::Type::PONG:
+	case BotMessage::Type::QUIT:
+		break;
+	}
+
+	const auto length = static_cast<uint32_t>(out.size() - start - HEADER);
+	for (size_t i = 0; i < HEADER; ++i)
+	{
+		out[start + i] = static_cast<uint8_t>(length >> (8 * i));
+	}
+}
+
+void BotChannel::flush()
+{
+	size_t written{};
+	while (written < this->output_.size())
+	{
+		const auto size   = static_cast<unsigned>(this->output_.size() - written);
+		const auto result = write(this->out_, this->output_.data() + written, size);
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (result <= 0)
+		{
+			throw std::runtime_error{ fmt::format("bot protocol: cannot write: {}", std::strerror(errno)) };
+		}
+		written += static_cast<size_t>(result);
+	}
+	this->output_.clear();
+}
+
+// Reads until at least the given number of bytes is buffered. Returns false at the end of the input.
+bool BotChannel::fill(size_t bytes)
+{
+	if (this->inputEnd_ - this->inputBegin_ >= bytes)
+	{
+		return true;
+	}
+	if (this->input_.size() - this->inputBegin_ < bytes)
+	{
+		std::memmove(this->input_.data(), this->input_.data() + this->inputBegin_, this->inputEnd_ - this->inputBegin_);
+		this->inputEnd_ -= this->inputBegin_;
+		this->inputBegin_ = 0;
+		if (this->input_.size() < bytes)
+		{
+			this->input_.resize(bytes);
+		}
+	}
+	while (this->inputEnd_ - this->inputBegin_ < bytes)
+	{
+		const auto space  = static_cast<unsigned>(this->input_.size() - this->inputEnd_);
+		const auto result = read(this->in_, this->input_.data() + this->inputEnd_, space);
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (result < 0)
+		{
+			throw std::runtime_error{ fmt::format("bot protocol: cannot read: {}", std::strerror(errno)) };
+		}
+		if (result == 0)
+		{
+			if (this->inputEnd_ != this->inputBegin_)
+			{
+				throw std::runtime_error{ "bot protocol: the input ends inside a message" };
+			}
+			return false;
+		}
+		this->inputEnd_ += static_cast<size_t>(result);
+	}
+	return true;
+}
+
+bool BotChannel::receive(BotMessage& message)
+{
+	if (!this->fill(HEADER))
+	{
+		return false;
+	}
+	Reader     header{ this->input_.data() + this->inputBegin_, HEADER };
+	const auto length = header.u32();
+	if (length < 5 || length > MAX_FRAME)
+	{
+		throw std::runtime_error{ fmt::format("bot protocol: bad message length {}", length) };
+	}
+	if (!this->fill(HEADER + length))
+	{
+		throw std::runtime_error{ "bot protocol: the input ends inside a message" };
+	}
+
+	Reader in{ this->input_.data() + this->inputBegin_ + HEADER, length };
+	this->inputBegin_ += HEADER + length;
+
+	message.type = static_cast<BotMessage::Type>(in.below(static_cast<int>(BotMessage::Type::QUIT) + 1, "message type"));
+	message.id   = in.u32();
+	message.moves.clear();
+	switch (message.type)
+	{
+	case BotMessage::Type::INFO:
+		message.version = in.u16();
+		message.name    = in.rest();
+		break;
+	case BotMessage::Type::SUGGEST:
+		message.state = get_state(in);
+		break;
+	case BotMessage::Type::SUGGESTION:
+		message.moves.resize(in.u8());
+		for (auto& move : message.moves)
+		{
+			move = get_move(in);
+		}
+		break;
+	case BotMessage::Type::PLAY:
+		message.played = in.u8();
+		break;
+	case BotMessage::Type::PING:
+	case BotMessage::Type::PONG:
+	case BotMessage::Type::QUIT:
+		break;
+	}
+	return true;
+}
+
+bool BotChannel::buffered() const
+{
+	const auto available = this->inputEnd_ - this->inputBegin_;
+	if (available < HEADER)
+	{
+		return false;
+	}
+	Reader header{ this->input_.data() + this->inputBegin_, HEADER };
+	return available - HEADER >= header.u32();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "grid.h"
+#include "tetromino.h"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct GameState;
+enum class InputEvent;
+
+// The protocol between the game and a bot running as another process, over a pair of pipes: the bot reads the game's
+// messages on its stdin and writes its own to its stdout.
+//
+// Every message is a frame: a 32 bit length, then that many bytes holding the message type, a 32 bit request id and the
+// payload. All integers are little endian. The bot starts by sending INFO. The game then asks for a move with SUGGEST,
+// which carries everything the bot may know about the position, and the bot answers with a SUGGESTION carrying the same
+// id: the moves it proposes, best first. The game plays the first of them it can and tells the bot which with a PLAY of
+// that id. Since a SUGGEST holds the whole position, a bot needs no state between requests, and the game may send more
+// requests (for other games, say) before the answers to the earlier ones arrive. The bot answers them in any order.
+struct BotState final
+{
+	Grid::Bitboard rows; // from the top, bit N for column N
+	TetrominoType  current;
+	Rotation       rotation;
+	int            row, column; // of the rotation state of the current tetromino, as in Grid::accepts()
+	TetrominoType  next;
+	uint8_t        bag; // bit T set for each TetrominoType T still in the bag the dealer draws from
+	uint32_t       pieces;
+
+	// The state of a game that has a playing tetromino.
+	static BotState of(const GameState& state);
+
+	// A game in this state, for a bot that searches with the game rules. The grid is of one color, the order of the bag is
+	// made up, and the frame clock starts at zero.
+	GameState gameState() const;
+};
+
+// Either where the current tetromino locks, in the terms of BotState, or the inputs to play for it. When the inputs leave
+// the tetromino playing, gravity takes it down.
+struct BotMove final
+{
+	enum class Kind : uint8_t
+	{
+		PLACEMENT,
+		INPUTS
+	};
+
+	Kind                    kind;
+	Rotation                rotation;
+	int                     row, column;
+	std::vector<InputEvent> inputs;
+};
+
+struct BotMessage final
+{
+	static constexpr uint16_t VERSION = 1;
+
+	enum class Type : uint8_t
+	{
+		INFO,       // bot: version, name
+		SUGGEST,    // game: state
+		SUGGESTION, // bot: moves
+		PLAY,       // game: played, the index of the move played, NONE for none
+		PING,       // either side, answered with a PONG of the same id
+		PONG,
+		QUIT // game: the bot should exit
+	};
+
+	static constexpr uint8_t NONE = 0xff;
+
+	Type                 type;
+	uint32_t             id{};
+	uint16_t             version{};
+	std::string          name{};
+	BotState             state{};
+	std::vector<BotMove> moves{};
+	uint8_t              played{ NONE };
+};
+
+// One end of the pipes: frames messages into a write buffer, and reads frames through a read buffer, so a burst of
+// messages costs one system call each way. Throws std::runtime_error when the other end breaks the protocol or an I/O
+// call fails.
+class BotChannel final
+{
+	int                  in_, out_;
+	std::vector<uint8_t> input_{};
+	size_t               inputBegin_{}, inputEnd_{};
+	std::vector<uint8_t> output_{};
+
+	bool fill(size_t bytes);
+
+public:
+	BotChannel(int in, int out);
+
+	// Appends the message to the write buffer.
+	void send(const BotMessage& message);
+	// Writes out the write buffer.
+	void flush();
+
+	// Waits for the next message. Returns false at the end of the input.
+	bool receive(BotMessage& message);
+
+	// Whether a whole message is buffered, so receive() returns without reading.
+	bool buffered() const;
+};
@@ -0,0 +1,59 @@
+#include "externalplayer.h"
+#include "botprocess.h"
+#include "simulation.h"
+#include "inputevent.h"
+#include "ai/pathfinder.h"
+
+ExternalPlayer::ExternalPlayer(std::shared_ptr<BotProcess> bot)
+    : bot_{ std::move(bot) }
+{
+}
+
+void ExternalPlayer::play(Simulation& simulation)
+{
+	const auto& board      = simulation.board();
+	const auto  pieces     = board.pieces();
+	const auto  suggestion = this->bot_->suggest(BotState::of(simulation.state()));
+
+	auto played = BotMessage::NONE;
+	for (size_t i = 0; i < suggestion.moves.size() && played == BotMessage::NONE; ++i)
+	{
+		const auto& move = suggestion.moves[i];
+		if (move.kind == BotMove::Kind::INPUTS)
+		{
+			// Inputs after the tetromino locks would steer the next one.
+			for (const auto input : move.inputs)
+			{
+				if (board.pieces() != pieces || board.gameOver())
+				{
+					break;
+				}
+				simulation.processInputEvent(input);
+			}
+			played = static_cast<uint8_t>(i);
+		}
+		else
+		{
+			// The bot is not trusted to stay inside the grid.
+			const auto& playing = *board.playingTetromino();
+			if (!board.grid().accepts(Tetromino{ playing.tetromino().type(), move.rotation }, GridPosition{ move.row, move.column }))
+			{
+				continue;
+			}
+			if (const auto path = ai::find_path(board.grid(), playing, ai::Placement{ move.rotation, move.row, move.column }))
+			{
+				for (const auto input : *path)
+				{
+					simulation.processInputEvent(input);
+				}
+				played = static_cast<uint8_t>(i);
+			}
+		}
+	}
+	this->bot_->play(suggestion.id, played);
+
+	if (played == BotMessage::NONE)
+	{
+		simulation.processInputEvent(InputEvent::HARD_DROP);
+	}
+}
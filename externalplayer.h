@@ -0,0 +1,20 @@
+#pragma once
+
+#include "iplayer.h"
+
+#include <memory>
+
+class BotProcess;
+
+// Plays the moves a bot in another process suggests. Any number of players may share one bot, each asking it for the
+// moves of its own game.
+class ExternalPlayer final : public IPlayer
+{
+	std::shared_ptr<BotProcess> bot_;
+
+public:
+	explicit ExternalPlayer(std::shared_ptr<BotProcess> bot);
+
+	// Plays the first suggested move that the playing tetromino can reach, and hard drops it when there is none.
+	void play(Simulation& simulation) override;
+};
@@ -1,249 +1,113 @@
 #include "game.h"
-#include "board.h"
-#include "grid.h"
-#include "offset.h"
-#include "bagofseven.h"
-#include "rotationdirection.h"
-#include "inputevent.h"
+#include "simulation.h"
 #include "itimer.h"
-#include "playingtetromino.h"
+#include "replay.h"
 
-#include <spdlog/spdlog.h>
-
-#include <stdexcept>
+#include <algorithm>
+#include <chrono>
 
 class Game::impl final
 {
-	static constexpr uint32_t LINES_LEVEL_UP  = 10;
-	static constexpr int      LOCKING_DELAY   = 500;
-	static constexpr int      SOFT_DROP_SCORE = 1;
-	static constexpr int      HARD_DROP_SCORE = 2;
+	using Clock = std::chrono::steady_clock;
 
-	std::function<void()>   onUpdate_;
 	std::unique_ptr<ITimer> timer_;
-	BagOfSeven              bagOfSeven_{};
-	std::unique_ptr<Board>  board_{};
-	uint32_t                linesForLevelUp_{ LINES_LEVEL_UP };
-	bool                    lockScheduled_{};
+	Simulation              simulation_;
+	Clock::time_point       timerStarted_{};
+	std::optional<Replay>   replay_{};
 
-	void reset()
+	static int framesToMilliseconds(int frames)
 	{
-		this->board_ = std::make_unique<Board>(this->bagOfSeven_.next());
-		this->board_->moveNextTetrominoToGrid(this->bagOfSeven_.next());
-		this->onUpdate_();
-		this->scheduleDescent();
+		return frames * 1000 / Simulation::FRAMES_PER_SECOND;
 	}
 
-	int descendInterval() const
+	// Arms the timer for the next event of the simulation, or stops it when nothing is scheduled.
+	void scheduleTimer()
 	{
-		const auto level = this->board_->level();
-		if (level >= 19)
-		{
-			return 1000 * 4 / 60;
-		}
-		else if (level >= 9)
+		const auto frames = this->simulation_.framesToNextEvent();
+		if (frames)
 		{
-			return 1000 * 6 / 60;
+			this->timerStarted_ = Clock::now();
+			this->timer_->start(framesToMilliseconds(frames.value()), [this]() { this->timeout(); });
 		}
 		else
 		{
-			return 1000 * (48 - 5 * level) / 60;
-		}
-	}
-
-	void scheduleDescent()
-	{
-		this->timer_->start(this->descendInterval(), std::bind(&impl::descend, this));
-		this->lockScheduled_ = false;
-		//qDebug() << "descent scheduled";
-	}
-
-	void scheduleLock()
-	{
-		if (!this->lockScheduled_)
-		{
-			this->timer_->start(LOCKING_DELAY, std::bind(&impl::lock, this));
-			this->lockScheduled_ = true;
-			//qDebug() << "lock scheduled";
+			this->timer_->stop();
 		}
 	}
 
-	void descend()
+	void timeout()
 	{
-		auto playingTetromino = this->board_->playingTetromino();
-		if (playingTetromino)
+		const auto frames = this->simulation_.framesToNextEvent();
+		if (frames)
 		{
-			const auto changed = playingTetromino->move(Offset{ 0, +1 });
-			if (changed)
-			{
-				//qDebug() << "descended";
-				this->afterChange();
-			}
+			this->simulation_.advance(frames.value());
 		}
+		this->scheduleTimer();
 	}
 
-	void lock()
+	// Brings the simulation clock up to the wall clock, short of the pending event, which is left to the timer.
+	void catchUp()
 	{
-		//qDebug() << "lock";
-
-		this->clearFullLines();
-
-		if (!this->board_->moveNextTetrominoToGrid(this->bagOfSeven_.next()))
-		{
-			return gameOver();
-		}
-
-		this->afterChange();
-	}
-
-	void afterChange()
-	{
-		//qDebug() << "after change";
-		auto playingTetromino = this->board_->playingTetromino();
-		if (playingTetromino)
-		{
-			if (playingTetromino->canDescend())
-			{
-				//qDebug() << "can descend";
-				this->scheduleDescent();
-			}
-			else
-			{
-				//qDebug() << "cannot descend";
-				this->scheduleLock();
-			}
-
-			this->onUpdate_();
-		}
-	}
-
-	void clearFullLines()
-	{
-		const auto linesCleared = this->board_->grid().clearFullLines();
-		if (linesCleared)
-		{
-			int score{};
-			switch (linesCleared)
-			{
-			case 1:
-				score = 40;
-				break;
-			case 2:
-				score = 100;
-				break;
-			case 3:
-				score = 300;
-				break;
-			case 4:
-				score = 1200;
-				break;
-			default:
-				throw std::runtime_error{ "should not happen" };
-			}
-			score *= (this->board_->level() + 1);
-			this->board_->addScore(score);
-		}
-
-		const auto totalLinesCleared = this->board_->lines() + linesCleared;
-		this->board_->setLines(totalLinesCleared);
-
-		while (totalLinesCleared >= this->linesForLevelUp_)
+		const auto frames = this->simulation_.framesToNextEvent();
+		if (frames)
 		{
-			this->levelUp();
-			this->linesForLevelUp_ += LINES_LEVEL_UP;
+			const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - this->timerStarted_).count() *
+			                     Simulation::FRAMES_PER_SECOND / 1000;
+			this->simulation_.advance(std::clamp<int64_t>(elapsed, 0, frames.value() - 1));
 		}
 	}
 
-	void levelUp()
+public:
+	explicit impl(std::function<void()> onUpdate, std::unique_ptr<ITimer> timer)
+	    : timer_{ std::move(timer) }
+	    , simulation_{ onUpdate }
 	{
-		this->board_->setLevel(this->board_->level() + 1);
 	}
 
-	void gameOver()
+	void start()
 	{
-		spdlog::info("GAME OVER");
-		this->board_->setGameOver();
-		this->timer_->stop();
-		this->onUpdate_();
+		this->simulation_.start();
+		this->replay_.emplace();
+		this->replay_->seed = this->simulation_.seed();
+		this->simulation_.record(&this->replay_->inputs);
+		this->scheduleTimer();
 	}
 
-	void newGame()
+	Board& board()
 	{
-		if (this->board_->gameOver())
-		{
-			this->reset();
-		}
+		return this->simulation_.board();
 	}
 
-public:
-	explicit impl(std::function<void()> onUpdate, std::unique_ptr<ITimer> timer)
-	    : onUpdate_{ onUpdate }
-	    , timer_{ std::move(timer) }
+	void processInputEvent(InputEvent event)
 	{
+		this->catchUp();
+		this->simulation_.processInputEvent(event);
+		this->scheduleTimer();
 	}
 
-	void start()
+	GameState snapshot() const
 	{
-		this->reset();
+		return this->simulation_.state();
 	}
 
-	Board& board()
+	void restore(const GameState& state)
 	{
-		return *this->board_;
+		this->simulation_.restore(state);
+		this->simulation_.record(nullptr);
+		this->replay_.reset();
+		this->scheduleTimer();
 	}
 
-	void processInputEvent(InputEvent event)
+	std::optional<Replay> replay() const
 	{
-		auto playingTetromino = this->board_->playingTetromino();
-		if (playingTetromino)
+		if (!this->replay_)
 		{
-			auto changed = false;
-
-			switch (event)
-			{
-			case InputEvent::MOVE_LEFT:
-				changed = playingTetromino->move(Offset{ -1, 0 });
-				break;
-			case InputEvent::MOVE_RIGHT:
-				changed = playingTetromino->move(Offset{ +1, 0 });
-				break;
-			case InputEvent::SOFT_DROP:
-				changed = playingTetromino->move(Offset{ 0, +1 });
-				if (changed)
-				{
-					this->board_->addScore(SOFT_DROP_SCORE);
-				}
-				break;
-			case InputEvent::HARD_DROP:
-			{
-				const auto rowsDropped = playingTetromino->hardDrop();
-				changed                = rowsDropped > 0;
-				if (changed)
-				{
-					this->board_->addScore(HARD_DROP_SCORE * rowsDropped);
-					return this->lock();
-				}
-				break;
-			}
-			case InputEvent::ROTATE_CLOCKWISE:
-				changed = playingTetromino->rotate(RotationDirection::CLOCKWISE);
-				break;
-			case InputEvent::ROTATE_COUNTER_CLOCKWISE:
-				changed = playingTetromino->rotate(RotationDirection::COUNTER_CLOCKWISE);
-				break;
-			case InputEvent::NEW_GAME:
-				return this->newGame();
-			}
-
-			if (changed)
-			{
-				this->afterChange();
-			}
-		}
-		else if (event == InputEvent::NEW_GAME)
-		{
-			return this->newGame();
+			return std::nullopt;
 		}
+		auto replay   = *this->replay_;
+		replay.frames = this->simulation_.frame();
+		replay.setResults(this->simulation_.state());
+		return replay;
 	}
 };
 
@@ -270,3 +134,18 @@ void Game::processInputEvent(InputEvent event)
 {
 	return this->pimpl_->processInputEvent(event);
 }
+
+GameState Game::snapshot() const
+{
+	return this->pimpl_->snapshot();
+}
+
+void Game::restore(const GameState& state)
+{
+	return this->pimpl_->restore(state);
+}
+
+std::optional<Replay> Game::replay() const
+{
+	return this->pimpl_->replay();
+}
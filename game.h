@@ -2,9 +2,12 @@
 
 #include <memory>
 #include <functional>
+#include <optional>
 
 class Board;
 class ITimer;
+struct GameState;
+struct Replay;
 enum class InputEvent;
 
 class Game final
@@ -21,4 +24,11 @@ public:
 	Board& board();
 
 	void processInputEvent(InputEvent event);
+
+	GameState snapshot() const;
+	void      restore(const GameState& state);
+
+	// The session so far: the inputs since start(), with the results of the game in progress. A restored state does not
+	// follow from the inputs, so there is none after restore().
+	std::optional<Replay> replay() const;
 };
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "board.h"
+#include "bagofseven.h"
+
+#include <optional>
+#include <cstdint>
+
+// Everything that determines how a game continues: the board with its grid, playing and next tetromino, score, lines and
+// level, the tetromino dealer, and the frame clock with the pending gravity or lock event. It is trivially copyable and a
+// few hundred bytes, so forking a game for a search, a rollback or a rewind is a single memcpy.
+struct GameState final
+{
+	enum class Event : uint8_t
+	{
+		NONE,
+		DESCEND,
+		LOCK
+	};
+
+	std::optional<Board> board{};
+	BagOfSeven           bagOfSeven{ 0 };
+	uint64_t             seed{};
+	uint64_t             frame{};
+	uint32_t             linesForLevelUp{};
+	Event                pendingEvent{ Event::NONE };
+	int                  pendingFrames{};
+};
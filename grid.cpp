@@ -1,31 +1,73 @@
 #include "grid.h"
 #include "gridposition.h"
 #include "tetromino.h"
+#include "bits.h"
+#include "tetrominocolor.h"
+#include "zobrist.h"
 
+#include <algorithm>
 #include <cassert>
+#include <type_traits>
+
+namespace {
+
+constexpr auto cell_keys = zobrist_keys<Grid::width() * Grid::height()>(0x6772696463656c6c);
+
+constexpr uint64_t cell_key(int row, int column)
+{
+	return cell_keys[row * Grid::width() + column];
+}
+
+constexpr uint64_t mirrored_cell_key(int row, int column)
+{
+	return cell_key(row, Grid::width() - 1 - column);
+}
+
+} // namespace
 
 bool Grid::rowIsFull(int row) const
 {
-	for (int column = 0; column < this->width(); ++column)
-	{
-		if (!this->cell(row, column).has_value())
-		{
-			return false;
-		}
-	}
-	return true;
+	return this->rows_[row] == FULL_ROW;
 }
 
 void Grid::deleteRow(int row)
 {
 	for (; row > 0; --row)
 	{
-		this->cells_[row] = this->cells_[row - 1];
+		this->colors_[row] = this->colors_[row - 1];
+		this->rows_[row]  = this->rows_[row - 1];
 	}
 	assert(row == 0);
-	for (int column = 0; column < this->width(); ++column)
+	this->colors_[row].fill(0);
+	this->rows_[row] = 0;
+}
+
+int Grid::topRow(int column) const
+{
+	return HEIGHT - this->columnHeights_[column];
+}
+
+// Rebuilds the column heights, the hole count and the hashes from the bitboard, top down.
+void Grid::recalculateMetadata()
+{
+	RowBits seen{};
+	this->holes_        = 0;
+	this->hash_         = 0;
+	this->mirroredHash_ = 0;
+	this->columnHeights_.fill(0);
+	for (int row = 0; row < HEIGHT; ++row)
 	{
-		this->cell(row, column) = std::nullopt;
+		this->holes_ += popcount(seen & ~this->rows_[row] & FULL_ROW);
+		for (uint32_t first = this->rows_[row] & ~seen; first; first &= first - 1)
+		{
+			this->columnHeights_[countr_zero(first)] = static_cast<uint8_t>(HEIGHT - row);
+		}
+		for (uint32_t bits = this->rows_[row]; bits; bits &= bits - 1)
+		{
+			this->hash_ ^= cell_key(row, countr_zero(bits));
+			this->mirroredHash_ ^= mirrored_cell_key(row, countr_zero(bits));
+		}
+		seen |= this->rows_[row];
 	}
 }
 
@@ -33,25 +75,118 @@ Grid::Grid()
 {
 }
 
-Grid::Cell& Grid::cell(int row, int column)
+Grid::Cell Grid::cell(int row, int column) const
 {
 	assert(row > -1 && row < HEIGHT && column > -1 && column < WIDTH);
-	return this->cells_[row][column];
+	const auto color = this->colors_[row][column];
+	return color ? Cell{ static_cast<TetrominoColor>(color - 1) } : std::nullopt;
 }
 
-const Grid::Cell& Grid::cell(int row, int column) const
+void Grid::setCell(int row, int column, const Cell& cell)
 {
 	assert(row > -1 && row < HEIGHT && column > -1 && column < WIDTH);
-	return this->cells_[row][column];
+	this->colors_[row][column] = cell.has_value() ? static_cast<Color>(static_cast<int>(cell.value()) + 1) : 0;
+
+	const auto bit      = RowBits(1u << column);
+	const auto occupied = (this->rows_[row] & bit) != 0;
+	if (cell.has_value() == occupied)
+	{
+		return;
+	}
+
+	this->hash_ ^= cell_key(row, column);
+	this->mirroredHash_ ^= mirrored_cell_key(row, column);
+
+	const auto top = this->topRow(column);
+	if (cell.has_value())
+	{
+		this->rows_[row] |= bit;
+		if (row < top)
+		{
+			// The cells between the new and the old top of the column become holes.
+			this->holes_ += top - row - 1;
+			this->columnHeights_[column] = static_cast<uint8_t>(HEIGHT - row);
+		}
+		else
+		{
+			--this->holes_;
+		}
+	}
+	else
+	{
+		this->rows_[row] &= RowBits(~bit);
+		if (row == top)
+		{
+			// The empty cells down to the next mino of the column are no longer holes.
+			int next = row + 1;
+			while (next < HEIGHT && !(this->rows_[next] & bit))
+			{
+				++next;
+			}
+			this->holes_ -= next - row - 1;
+			this->columnHeights_[column] = static_cast<uint8_t>(HEIGHT - next);
+		}
+		else
+		{
+			++this->holes_;
+		}
+	}
+}
+
+Grid::RowBits Grid::rowBits(int row) const
+{
+	assert(row > -1 && row < HEIGHT);
+	return this->rows_[row];
+}
+
+const Grid::Bitboard& Grid::bitboard() const
+{
+	static_assert(std::is_same<Bitboard, decltype(rows_)>::value, "the bitboard is the row array");
+	return this->rows_;
+}
+
+int Grid::columnHeight(int column) const
+{
+	assert(column > -1 && column < WIDTH);
+	return this->columnHeights_[column];
+}
+
+int Grid::rowFill(int row) const
+{
+	assert(row > -1 && row < HEIGHT);
+	return popcount(this->rows_[row]);
+}
+
+int Grid::holes() const
+{
+	return this->holes_;
+}
+
+uint64_t Grid::hash() const
+{
+	return this->hash_;
+}
+
+uint64_t Grid::mirroredHash() const
+{
+	return this->mirroredHash_;
 }
 
 bool Grid::accepts(const Tetromino& tetromino, const GridPosition& position) const
 {
-	for (const auto& offs : tetromino.rotationState())
+	const auto& box = tetromino.boundingBox();
+	if (position.column + box.minX < 0 || position.column + box.maxX >= WIDTH || position.row + box.minY < 0 ||
+	    position.row + box.maxY >= HEIGHT)
+	{
+		return false;
+	}
+
+	// The bounding box test above guarantees that no bits are shifted past either wall.
+	const auto& masks = tetromino.rotationMasks();
+	for (int y = box.minY; y <= box.maxY; ++y)
 	{
-		const auto row    = position.row + offs.y;
-		const auto column = position.column + offs.x;
-		if (column < 0 || column >= WIDTH || row < 0 || row >= HEIGHT || this->cells_[row][column])
+		const uint32_t mask = position.column >= 0 ? uint32_t{ masks[y] } << position.column : uint32_t{ masks[y] } >> -position.column;
+		if (mask & this->rows_[position.row + y])
 		{
 			return false;
 		}
@@ -59,6 +194,45 @@ bool Grid::accepts(const Tetromino& tetromino, const GridPosition& position) con
 	return true;
 }
 
+void Grid::place(const Tetromino& tetromino, const GridPosition& position)
+{
+	assert(this->accepts(tetromino, position));
+	for (const auto& offs : tetromino.rotationState())
+	{
+		this->setCell(position.row + offs.y, position.column + offs.x, tetromino.color());
+	}
+}
+
+int Grid::dropDistance(const Tetromino& tetromino, const GridPosition& position) const
+{
+	assert(this->accepts(tetromino, position));
+
+	// When every column of the tetromino is above the stack, the column heights alone give the distance.
+	const auto& box       = tetromino.boundingBox();
+	const auto& bottoms   = tetromino.columnBottoms();
+	auto        distance  = HEIGHT;
+	auto        aboveRest = true;
+	for (int x = box.minX; x <= box.maxX && aboveRest; ++x)
+	{
+		const auto bottom = position.row + bottoms[x];
+		const auto top    = this->topRow(position.column + x);
+		aboveRest         = bottom < top;
+		distance          = std::min(distance, top - bottom - 1);
+	}
+	if (aboveRest)
+	{
+		return distance;
+	}
+
+	// Part of the tetromino is tucked under an overhang: step down row by row.
+	distance = 0;
+	while (this->accepts(tetromino, GridPosition{ position.row + distance + 1, position.column }))
+	{
+		++distance;
+	}
+	return distance;
+}
+
 int Grid::clearFullLines()
 {
 	int linesCleared{};
@@ -74,5 +248,35 @@ int Grid::clearFullLines()
 			--row;
 		}
 	}
+	if (linesCleared)
+	{
+		this->recalculateMetadata();
+	}
 	return linesCleared;
 }
+
+bool Grid::insertGarbage(int rows, int holeColumn)
+{
+	assert(rows >= 0 && rows <= HEIGHT && holeColumn > -1 && holeColumn < WIDTH);
+	if (rows == 0)
+	{
+		return true;
+	}
+
+	const auto fits = std::all_of(this->rows_.begin(), this->rows_.begin() + rows, [](RowBits row) { return row == 0; });
+
+	std::copy(this->rows_.begin() + rows, this->rows_.end(), this->rows_.begin());
+	std::copy(this->colors_.begin() + rows, this->colors_.end(), this->colors_.begin());
+
+	std::array<Color, WIDTH> garbage{};
+	garbage.fill(static_cast<Color>(static_cast<int>(TetrominoColor::GREY) + 1));
+	garbage[holeColumn] = 0;
+	for (int row = HEIGHT - rows; row < HEIGHT; ++row)
+	{
+		this->rows_[row]   = FULL_ROW & RowBits(~(1u << holeColumn));
+		this->colors_[row] = garbage;
+	}
+
+	this->recalculateMetadata();
+	return fits;
+}
@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <array>
+#include <cstdint>
 
 class Tetromino;
 class GridPosition;
@@ -14,12 +15,32 @@ class Grid final
 
 	using Cell = std::optional<TetrominoColor>;
 
-	std::array<std::array<Cell, WIDTH>, HEIGHT> cells_{};
+	// Occupancy bitboard, one word per row. Bit N is set when column N holds a mino.
+	using RowBits = uint16_t;
+
+	static constexpr RowBits FULL_ROW = (1u << WIDTH) - 1;
+
+	// 0 for an empty cell, else the TetrominoColor plus one. Keeps the grid small enough to snapshot by the million.
+	using Color = uint8_t;
+
+	std::array<std::array<Color, WIDTH>, HEIGHT> colors_{};
+	std::array<RowBits, HEIGHT>                  rows_{};
+
+	// Derived from rows_, and kept up to date as cells are written and lines are cleared.
+	std::array<uint8_t, WIDTH> columnHeights_{};
+	int                        holes_{};
+
+	// Zobrist hashes of the occupancy, and of the occupancy mirrored left to right.
+	uint64_t hash_{};
+	uint64_t mirroredHash_{};
 
 	bool rowIsFull(int row) const;
 
 	void deleteRow(int row);
 
+	int  topRow(int column) const;
+	void recalculateMetadata();
+
 public:
 	Grid();
 
@@ -33,10 +54,40 @@ public:
 		return HEIGHT;
 	}
 
-	Cell&       cell(int row, int column);
-	const Cell& cell(int row, int column) const;
+	Cell cell(int row, int column) const;
+	void setCell(int row, int column, const Cell& cell);
+
+	RowBits rowBits(int row) const;
+
+	// The occupancy bitboard as it is stored: one word per row from the top, bit N for column N. Contiguous arrays of
+	// these are what the batch feature extractor reads.
+	using Bitboard = std::array<uint16_t, HEIGHT>;
+
+	const Bitboard& bitboard() const;
+
+	// Number of rows from the bottom up to and including the highest mino of the column, 0 for an empty column.
+	int columnHeight(int column) const;
+	// Number of minos in the row.
+	int rowFill(int row) const;
+	// Number of empty cells that have a mino somewhere above them in the same column.
+	int holes() const;
+
+	// Zobrist hash of which cells are occupied (colors do not count), kept up to date as cells are written and lines are
+	// cleared. mirroredHash() is the hash the left-right mirror image of the grid would have, so a grid and its mirror image
+	// are recognized by hash() == other.mirroredHash().
+	uint64_t hash() const;
+	uint64_t mirroredHash() const;
 
 	bool accepts(const Tetromino& tetromino, const GridPosition& position) const;
+	void place(const Tetromino& tetromino, const GridPosition& position);
+
+	// Number of rows the tetromino can fall from a position it is accepted at, before it lands.
+	int dropDistance(const Tetromino& tetromino, const GridPosition& position) const;
 
 	int clearFullLines();
+
+	// Pushes the whole stack up by the given number of rows, and fills the rows that open up at the bottom with garbage:
+	// grey minos in every column but the hole column. Moves whole rows, like clearing lines. Returns false when minos were
+	// pushed out at the top.
+	bool insertGarbage(int rows, int holeColumn);
 };
@@ -113,7 +113,7 @@ void BoardRenderer::render(const Board& board, const QPoint& boardOrigin)
 	{
 		for (int column = 0; column < Grid::width(); ++column)
 		{
-			const auto& cell = board.grid().cell(row, column);
+			const auto cell = board.cell(row, column);
 			if (cell.has_value())
 			{
 				minoRenderer.render(painter, QPoint{ column * minoSize, row * minoSize } + origin, cell.value());
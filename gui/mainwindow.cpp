@@ -3,42 +3,115 @@
 #include "boardrenderer.h"
 #include "inputevent.h"
 #include "timer.h"
+#include "replay.h"
+#include "replayplayback.h"
+#include "ai/autopilot.h"
 
 #include <QKeyEvent>
 
-void MainWindow::paintEvent(QPaintEvent*)
-{
-	this->boardRenderer_->render(this->game_->board(), QPoint{ this->margins_.left(), this->margins_.top() });
-}
+#include <algorithm>
 
-void MainWindow::keyPressEvent(QKeyEvent* event)
+namespace {
+
+std::optional<InputEvent> input_event(int key)
 {
-	switch (event->key())
+	switch (key)
 	{
 	case Qt::Key_Left:
-		return this->game_->processInputEvent(InputEvent::MOVE_LEFT);
+		return InputEvent::MOVE_LEFT;
 	case Qt::Key_Right:
-		return this->game_->processInputEvent(InputEvent::MOVE_RIGHT);
+		return InputEvent::MOVE_RIGHT;
 	case Qt::Key_Down:
-		return this->game_->processInputEvent(InputEvent::SOFT_DROP);
+		return InputEvent::SOFT_DROP;
 	case Qt::Key_Space:
-		return this->game_->processInputEvent(InputEvent::HARD_DROP);
+		return InputEvent::HARD_DROP;
 	case Qt::Key_Up:
 	case Qt::Key_X:
-		return this->game_->processInputEvent(InputEvent::ROTATE_CLOCKWISE);
+		return InputEvent::ROTATE_CLOCKWISE;
 	case Qt::Key_Control:
 	case Qt::Key_Z:
-		return this->game_->processInputEvent(InputEvent::ROTATE_COUNTER_CLOCKWISE);
+		return InputEvent::ROTATE_COUNTER_CLOCKWISE;
 	case Qt::Key_F1:
-		return this->game_->processInputEvent(InputEvent::NEW_GAME);
+		return InputEvent::NEW_GAME;
+	}
+	return std::nullopt;
+}
+
+} // namespace
+
+void MainWindow::paintEvent(QPaintEvent*)
+{
+	if (this->versus_)
+	{
+		const auto width = this->boardRenderer_->size().width() + this->margins_.left();
+		for (size_t i = 0; i < this->versus_->boards(); ++i)
+		{
+			const auto left = this->margins_.left() + static_cast<int>(i) * width;
+			this->boardRenderer_->render(this->versus_->board(i), QPoint{ left, this->margins_.top() });
+		}
+		return;
+	}
+	const auto& board = this->playback_ ? this->playback_->board() : this->game_->board();
+	this->boardRenderer_->render(board, QPoint{ this->margins_.left(), this->margins_.top() });
+}
+
+void MainWindow::keyPressEvent(QKeyEvent* event)
+{
+	if (this->playback_)
+	{
+		const auto frame = this->playback_->frame();
+		switch (event->key())
+		{
+		case Qt::Key_Left:
+			return this->playback_->seek(frame - std::min(frame, ReplayPlayback::SEEK_STEP));
+		case Qt::Key_Right:
+			return this->playback_->seek(frame + ReplayPlayback::SEEK_STEP);
+		}
+		return;
+	}
+
+	const auto input = input_event(event->key());
+	if (this->versus_)
+	{
+		if (input)
+		{
+			this->versus_->processInputEvent(*input);
+		}
+	}
+	else if (input)
+	{
+		this->game_->processInputEvent(*input);
+	}
+	else if (event->key() == Qt::Key_F2)
+	{
+		this->autopilot_->toggle();
 	}
 }
 
 MainWindow::MainWindow(QWidget* parent)
+    : MainWindow(parent, nullptr, 1, std::nullopt)
+{
+}
+
+MainWindow::MainWindow(std::shared_ptr<const ReplayFile> replay, double speed, QWidget* parent)
+    : MainWindow(parent, std::move(replay), speed, std::nullopt)
+{
+}
+
+MainWindow::MainWindow(const ai::VersusGame::Options& versus, QWidget* parent)
+    : MainWindow(parent, nullptr, 1, versus)
+{
+}
+
+MainWindow::MainWindow(QWidget*                               parent,
+                       std::shared_ptr<const ReplayFile>      replay,
+                       double                                 speed,
+                       std::optional<ai::VersusGame::Options> versus)
     : QWidget(parent)
     , margins_{ 20, 20, 20, 20 }
     , boardRenderer_{ std::make_unique<gui::BoardRenderer>(this) }
     , game_{ std::make_unique<Game>([this]() { this->update(); }, std::make_unique<gui::Timer>()) }
+    , autopilot_{ std::make_unique<ai::Autopilot>(*this->game_, std::make_unique<gui::Timer>()) }
 {
 	auto palette = this->palette();
 	palette.setColor(QPalette::Window, Qt::black);
@@ -46,11 +119,36 @@ MainWindow::MainWindow(QWidget* parent)
 
 	this->setAutoFillBackground(true);
 
-	this->setFixedSize(this->boardRenderer_->size().grownBy(this->margins_));
+	auto size = this->boardRenderer_->size();
+	if (versus)
+	{
+		const auto boards = static_cast<int>(versus->boards);
+		size.setWidth(boards * size.width() + (boards - 1) * this->margins_.left());
+	}
+	this->setFixedSize(size.grownBy(this->margins_));
 
-	this->game_->start();
+	if (versus)
+	{
+		auto timer    = std::make_unique<gui::Timer>();
+		this->versus_ = std::make_unique<ai::VersusGame>(*versus, [this]() { this->update(); }, std::move(timer));
+		this->versus_->start();
+	}
+	else if (replay)
+	{
+		auto timer      = std::make_unique<gui::Timer>();
+		this->playback_ = std::make_unique<ReplayPlayback>(std::move(replay), [this]() { this->update(); }, std::move(timer), speed);
+		this->playback_->start();
+	}
+	else
+	{
+		this->game_->start();
+	}
 }
 
 MainWindow::~MainWindow()
 {
+	if (const auto replay = this->game_->replay(); replay && !replay->inputs.empty())
+	{
+		replay->archive();
+	}
 }
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "ai/versusgame.h"
+
 #include <QWidget>
 
 #include <memory>
+#include <optional>
 
 class Game;
+class ReplayPlayback;
+class ReplayFile;
 
 namespace gui {
 
@@ -12,6 +17,12 @@ class BoardRenderer;
 
 }
 
+namespace ai {
+
+class Autopilot;
+
+}
+
 class MainWindow final : public QWidget
 {
 	Q_OBJECT
@@ -19,11 +30,20 @@ class MainWindow final : public QWidget
 	QMargins                            margins_;
 	std::unique_ptr<gui::BoardRenderer> boardRenderer_{};
 	std::unique_ptr<Game>               game_{};
+	std::unique_ptr<ai::Autopilot>      autopilot_{};
+	std::unique_ptr<ReplayPlayback>     playback_{};
+	std::unique_ptr<ai::VersusGame>     versus_{};
+
+	MainWindow(QWidget* parent, std::shared_ptr<const ReplayFile> replay, double speed, std::optional<ai::VersusGame::Options> versus);
 
 	void paintEvent(QPaintEvent* event) override;
 	void keyPressEvent(QKeyEvent* event) override;
 
 public:
 	MainWindow(QWidget* parent = nullptr);
+	// Plays the replay back instead of a game. The arrow keys seek.
+	MainWindow(std::shared_ptr<const ReplayFile> replay, double speed, QWidget* parent = nullptr);
+	// Plays a versus match against AI opponents instead of a game, the boards side by side.
+	explicit MainWindow(const ai::VersusGame::Options& versus, QWidget* parent = nullptr);
 	~MainWindow();
 };
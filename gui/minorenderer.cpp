@@ -26,7 +26,7 @@ const MinoColorsMapType& mino_colors_map()
 		{ TetrominoColor::YELLOW, MinoRenderer::yellowColors }, { TetrominoColor::RED, MinoRenderer::redColors },
 		{ TetrominoColor::PURPLE, MinoRenderer::purpleColors }, { TetrominoColor::GREEN, MinoRenderer::greenColors },
 		{ TetrominoColor::ORANGE, MinoRenderer::orangeColors }, { TetrominoColor::BLUE, MinoRenderer::blueColors },
-		{ TetrominoColor::CYAN, MinoRenderer::cyanColors }
+		{ TetrominoColor::CYAN, MinoRenderer::cyanColors }, { TetrominoColor::GREY, MinoRenderer::greyColors }
 	};
 	return _;
 }
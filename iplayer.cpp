@@ -0,0 +1,10 @@
+#include "iplayer.h"
+
+IPlayer::~IPlayer() noexcept
+{
+}
+
+uint64_t IPlayer::rollouts() const
+{
+	return 0;
+}
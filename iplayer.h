@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+class Simulation;
+
+// Something that plays a headless game: a script, a heuristic bot, a search.
+class IPlayer
+{
+public:
+	virtual ~IPlayer() noexcept;
+
+	// Feeds the inputs for the playing tetromino into the simulation, normally ending with a hard drop. When the tetromino
+	// is still playing afterwards, the caller lets the simulation run until it locks.
+	virtual void play(Simulation& simulation) = 0;
+
+	// Number of games played out so far, for players that search by playing placements out.
+	virtual uint64_t rollouts() const;
+};
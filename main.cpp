@@ -1,37 +1,86 @@
 #include "gui/mainwindow.h"
 #include "tui/tuiapp.h"
+#include "allocationcheck.h"
+#include "arguments.h"
+#include "batchrunner.h"
+#include "botprocess.h"
+#include "externalplayer.h"
+#include "randomplayer.h"
+#include "threadpool.h"
+#include "tournament.h"
+#include "ai/aiplayer.h"
+#include "ai/heuristicevaluator.h"
+#include "ai/transpositiontable.h"
+#include "ai/beamsearch.h"
+#include "ai/montecarlosearch.h"
+#include "ai/perfectclearsolver.h"
+#include "ai/networkevaluator.h"
+#include "ai/lockstepplayer.h"
+#include "ai/movegenerator.h"
+#include "ai/boardfeatures.h"
+#include "ai/weighttuner.h"
+#include "ai/botserver.h"
+#include "ai/opponent.h"
+#include "ai/battleroyale.h"
+#include "ai/versusgame.h"
+#include "replay.h"
+#include "replayverifier.h"
+#include "simulation.h"
+#include "versus.h"
+#include "xoshiro256.h"
 
 #include <QApplication>
 #include <QDebug>
 
+#include <fmt/format.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
 
 #if defined(Q_OS_MACOS)
 #include <CoreGraphics/CGSession.h>
+#elif defined(Q_OS_WIN)
+#include <fcntl.h>
+#include <io.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 
 namespace {
 
-int run_gui(int argc, char* argv[])
+// The game, or the playback of a replay when there is one.
+int run_gui(int argc, char* argv[], std::shared_ptr<const ReplayFile> replay = nullptr, double speed = 1)
 {
 	QApplication a{ argc, argv };
-	MainWindow   w{};
+	const auto   w = replay ? std::make_unique<MainWindow>(std::move(replay), speed) : std::make_unique<MainWindow>();
+	w->show();
+	return a.exec();
+}
+
+int run_gui(int argc, char* argv[], const ai::VersusGame::Options& versus)
+{
+	QApplication a{ argc, argv };
+	MainWindow   w{ versus };
 	w.show();
 	return a.exec();
 }
 
-int run_tui(int argc, char* argv[])
+int run_tui(int argc, char* argv[], std::shared_ptr<const ReplayFile> replay = nullptr, double speed = 1)
 {
 	(void)argc;
 	(void)argv;
 
 	try
 	{
-		return TuiApp{}.run();
+		return replay ? TuiApp{ std::move(replay), speed }.run() : TuiApp{}.run();
 	}
 	catch (const std::exception& e)
 	{
@@ -40,22 +89,542 @@ int run_tui(int argc, char* argv[])
 	}
 }
 
-} // namespace
+int run_tui(const ai::VersusGame::Options& versus)
+{
+	try
+	{
+		return TuiApp{ versus }.run();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
 
-int main(int argc, char* argv[])
+constexpr auto USAGE = R"(usage: tetris [<command> [--option value]...]
+
+Without a command, tetris starts the graphical game when a display is available and the terminal game otherwise.
+
+commands:
+  batch      play headless games in parallel and report statistics
+             --games N (1000)  --seed S (1)  --threads T (all cores)  --max-pieces P (no limit, 1000 for ai, 200 for mc)
+             --player random|ai|nn|mc|bot (random)  --replays DIR   save the replay of every game to DIR/<game>.replay
+             --keyframes K (600)   frames between the keyframes of the replays, 0 for none
+             ai: beam search   --width W (8)  --depth D (2)
+                               --table E (65536)   entries of the transposition table the players share, 0 for none
+             nn: beam search as ai, scoring boards with the network   --weights FILE (the heuristic as a network)
+             mc: Monte Carlo   --candidates C (6)  --rollouts R (32)  --horizon H (8)
+             ai, nn and mc: --heuristic FILE (heuristic.weights if present, else the built-in ones)   weights written by tune
+             bot: a bot process all games share   --command CMD   run by the shell, such as "tetris bot --player mc"
+  bot        serve the bot protocol on stdin and stdout, for a game in another process
+             --player ai|nn|mc (ai) with the options of batch  --seed S (1)  --threads T (all cores)
+  ping       time round trips to a bot process   --command CMD  --count N (10000)  --seed S (1)
+  tournament rate players against each other, all of them playing the same seeds, with Elo ratings and 95% intervals
+             --players LIST (random,ai:depth=1,ai)   comma separated, each a player of batch with its options after colons,
+                                                     such as ai:width=4:depth=1, mc:rollouts=16 or nn:weights=FILE
+             --games N (100)   seeds, each played by every player  --seed S (1)  --threads T (all cores)
+             --max-pieces P (1000)  --bootstraps B (200)   resamples for the intervals
+             --versus   play each pair against each other instead, a versus match per seed in either seating, won by
+                        the board left standing   --garbage LIST  --pace F (6), or :pace=F for a player
+                        --max-frames F (36000)   a match still going by then is a draw
+  replay     play a replay back, in the window or terminal at real speed, or headless as fast as possible
+             --file FILE  --speed X (1)  --tui   play it in the terminal even when there is a display
+             --headless  --repeat N (1)   play it N times and report the time one takes
+                         --seek F   and the state at frame F, through the keyframes, and the time a seek takes
+             The arrow keys seek 10 seconds back and forward during the playback.
+             --save FILE  --keyframes K (600)   write the replay again, with a keyframe every K frames
+             The game saves every session to replays/ in the working directory.
+  verify     play replays again headless in parallel, and check the score, lines and level each claims
+             --dir DIR   the .replay files under DIR  --list FILE   the paths in FILE, one per line, - for stdin
+             --threads T (all cores)  --failures   list only the replays that do not pass
+  versus     play against AI opponents on boards side by side, clearing lines to send them garbage
+             --boards N (2)   2 to 4  --garbage LIST (0,0,1,2,4)   rows sent for clearing 0 to 4 lines at once
+             --pace F (6)   frames between the inputs of an opponent  --tui   play in the terminal even when there is a display
+             --headless   let the opponents play each other instead, and report who wins and how fast matches run
+                          --games N (100)  --seed S (1)  --threads T (all cores)  --max-frames F (36000)
+                          --player ai|nn|mc (ai) with the options of batch
+  royale     play a battle royale of bots headless, stepping the boards on all cores, and report whether it keeps up
+             with real time, the time each frame takes and the memory each board needs
+             --boards N (99)  --seed S (1)  --threads T (all cores)  --max-frames F (36000)  --real-time   keep to the clock
+             --targeting random|attackers (random)  --garbage LIST  --pace F  --player ai|nn|mc (ai) as for versus
+  pc         look for a perfect clear from the opening of many games and report how often and how fast one is found
+             --games N (100)  --seed S (1)  --threads T (all cores)  --lines L (4)  --pieces P (11)
+  nn         play many games in lockstep on one thread, scoring the placements of all of them in one network batch
+             --games N (64)  --seed S (1)  --pieces P (100)  --weights FILE  --scalar (no AVX2)  --save FILE
+  features   time the batch feature extractor against a loop over the cells of each grid
+             --grids N (100000)  --seed S (1)
+  allocations
+             check that games in progress do not allocate: hard drop tetrominoes over many seeded games, counting the calls
+             to operator new after the first game, and fail when there are any   --pieces N (10000)  --seed S (1)
+  tune       tune the heuristic weights with CMA-ES, scoring each candidate by the mean lines of headless games
+             --generations G (100)  --population L (8)  --games N (32)  --max-pieces P (1000)  --depth D (1)
+             --sigma S (0.3)  --seed S (1)  --threads T (all cores)  --heuristic FILE (start from these weights)
+             --checkpoint FILE (tune.checkpoint)  --resume   continue from the checkpoint, with its options, up to G generations
+             --out FILE (heuristic.weights)   the weights, rewritten every generation; the players load this file
+)";
+
+ai::HeuristicEvaluator::Weights load_heuristic(const Arguments& args)
 {
-	auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>("tetris.log", false);
-	sink->set_level(spdlog::level::trace);
+	if (args.has("heuristic"))
+	{
+		return ai::HeuristicEvaluator::Weights::load(args.text("heuristic", ""));
+	}
+	return ai::HeuristicEvaluator::Weights::startup();
+}
 
-	auto logger = std::make_shared<spdlog::logger>("", sink);
-	logger->flush_on(spdlog::level::trace);
+ai::NetworkEvaluator::Network load_network(const Arguments& args)
+{
+	if (args.has("weights"))
+	{
+		return ai::NetworkEvaluator::Network::load(args.text("weights", ""));
+	}
+	return ai::NetworkEvaluator::Network::of(load_heuristic(args));
+}
 
-	spdlog::set_default_logger(logger);
-	spdlog::set_level(spdlog::level::trace);
+using SearchFactory = std::function<std::unique_ptr<ai::ISearch>(uint64_t seed)>;
+
+// The searches the ai, nn and mc players and the bot use, configured by the options given for them. The factory owns
+// what the searches share: the evaluator, the network and the transposition table.
+SearchFactory search_factory(const std::string& player, const Arguments& args, ThreadPool& pool)
+{
+	const auto evaluator = std::make_shared<const ai::HeuristicEvaluator>(load_heuristic(args));
+
+	if (player == "ai" || player == "nn")
+	{
+		const auto network = player == "nn" ? std::make_shared<const ai::NetworkEvaluator>(load_network(args)) : nullptr;
+
+		auto searchOptions  = ai::BeamSearch::Options{};
+		searchOptions.width = static_cast<int>(args.number("width", searchOptions.width));
+		searchOptions.depth = static_cast<int>(args.number("depth", searchOptions.depth));
+
+		const auto entries = args.number("table", 1u << 16);
+		const auto table   = entries ? std::make_shared<ai::TranspositionTable>(entries) : nullptr;
+
+		// The games already keep every thread busy, so each search runs on its own thread.
+		return [evaluator, network, table, searchOptions](uint64_t) -> std::unique_ptr<ai::ISearch> {
+			const auto& scorer = network ? static_cast<const ai::IEvaluator&>(*network) : *evaluator;
+			return std::make_unique<ai::BeamSearch>(scorer, searchOptions, nullptr, table.get());
+		};
+	}
+	if (player == "mc")
+	{
+		auto searchOptions       = ai::MonteCarloSearch::Options{};
+		searchOptions.candidates = static_cast<int>(args.number("candidates", searchOptions.candidates));
+		searchOptions.rollouts   = static_cast<int>(args.number("rollouts", searchOptions.rollouts));
+		searchOptions.horizon    = static_cast<int>(args.number("horizon", searchOptions.horizon));
+
+		// Rollouts are spread over the pool too, which keeps all threads busy when there are fewer games than threads.
+		return [evaluator, searchOptions, &pool](uint64_t seed) -> std::unique_ptr<ai::ISearch> {
+			auto gameOptions = searchOptions;
+			gameOptions.seed = seed;
+			return std::make_unique<ai::MonteCarloSearch>(*evaluator, gameOptions, &pool);
+		};
+	}
+	throw std::invalid_argument{ "unknown player: " + player };
+}
+
+// The players batch and tournament know, configured by the options given for them.
+BatchRunner::PlayerFactory player_factory(const std::string& player, const Arguments& args, ThreadPool& pool)
+{
+	if (player == "random")
+	{
+		return [](uint64_t seed) { return std::make_unique<RandomPlayer>(seed); };
+	}
+	if (player == "bot")
+	{
+		if (!args.has("command"))
+		{
+			throw std::invalid_argument{ "the bot player needs --command" };
+		}
+
+		// All games share one bot process, which answers them in the order their requests arrive.
+		const auto bot = std::make_shared<BotProcess>(args.text("command", ""));
+		return [bot](uint64_t) { return std::make_unique<ExternalPlayer>(bot); };
+	}
+
+	const auto searchFactory = search_factory(player, args, pool);
+	return [searchFactory](uint64_t seed) { return std::make_unique<ai::AiPlayer>(searchFactory(seed)); };
+}
+
+// The opponents versus and tournament know: a search per board, with an input every so many frames.
+Versus::ControllerFactory controller_factory(const std::string& player, const Arguments& args, ThreadPool& pool, int pace)
+{
+	const auto searchFactory = search_factory(player, args, pool);
+	return [searchFactory, pace](uint64_t seed) -> Versus::Controller {
+		const auto opponent = std::make_shared<ai::Opponent>(searchFactory(seed), pace, seed);
+		return [opponent](const GameState& state) { return opponent->act(state); };
+	};
+}
+
+int run_batch(const Arguments& args)
+{
+	const auto player = args.text("player", "random");
+
+	// A good player rarely tops out, so its games need a length limit.
+	const auto maxPieces = player == "ai" || player == "nn" || player == "bot" ? 1000 : player == "mc" ? 200 : 0;
+
+	BatchRunner::Options options{};
+	options.games     = args.number("games", options.games);
+	options.seed      = args.number("seed", options.seed);
+	options.maxPieces = static_cast<uint32_t>(args.number("max-pieces", maxPieces));
+	options.replays   = args.text("replays", "");
+	options.keyframes = args.number("keyframes", options.keyframes);
+
+	ThreadPool pool{ static_cast<unsigned>(args.number("threads", 0)) };
+
+	std::cout << BatchRunner::run(pool, options, player_factory(player, args, pool)).summary();
+	return 0;
+}
+
+int run_bot(const Arguments& args)
+{
+	const auto player = args.text("player", "ai");
+
+	ThreadPool    pool{ static_cast<unsigned>(args.number("threads", 0)) };
+	const auto    searchFactory = search_factory(player, args, pool);
+	ai::BotServer server{ searchFactory(args.number("seed", 1)), "tetris " + player };
+
+#if defined(Q_OS_WIN)
+	_setmode(0, _O_BINARY);
+	_setmode(1, _O_BINARY);
+#endif
+	// The protocol takes up stdin and stdout.
+	server.run(0, 1);
+	return 0;
+}
+
+int run_ping(const Arguments& args)
+{
+	if (!args.has("command"))
+	{
+		throw std::invalid_argument{ "ping needs --command" };
+	}
+	const auto count = args.number("count", 10000);
+
+	BotProcess bot{ args.text("command", "") };
+
+	const auto microseconds = [](std::chrono::steady_clock::time_point started) {
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count();
+	};
+
+	std::vector<double> pings{};
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		const auto started = std::chrono::steady_clock::now();
+		bot.ping();
+		pings.push_back(microseconds(started));
+	}
+
+	const auto started   = std::chrono::steady_clock::now();
+	bot.ping(count);
+	const auto pipelined = microseconds(started) / static_cast<double>(count);
+
+	// A real request, which includes the time the bot takes to choose.
+	Simulation simulation{};
+	simulation.start(args.number("seed", 1));
+	const auto          state = BotState::of(simulation.state());
+	std::vector<double> suggestions{};
+	for (uint64_t i = 0; i < std::max<uint64_t>(count / 10, 1); ++i)
+	{
+		const auto suggestionStarted = std::chrono::steady_clock::now();
+		bot.play(bot.suggest(state).id, 0);
+		suggestions.push_back(microseconds(suggestionStarted));
+	}
+
+	const auto ping    = Distribution::of(pings);
+	const auto suggest = Distribution::of(suggestions);
+	std::cout << fmt::format("bot '{}'\n", bot.name());
+	std::cout << fmt::format("ping round trip us   mean {:.1f}  p10 {:.1f}  p50 {:.1f}  p90 {:.1f}  max {:.1f}\n",
+	                         ping.mean,
+	                         ping.p10,
+	                         ping.p50,
+	                         ping.p90,
+	                         ping.max);
+	std::cout << fmt::format("pipelined pings us   {:.2f} each, {} sent at once\n", pipelined, count);
+	std::cout << fmt::format("suggest round trip us  mean {:.1f}  p50 {:.1f}  p90 {:.1f}   the opening position, with the bot's search\n",
+	                         suggest.mean,
+	                         suggest.p50,
+	                         suggest.p90);
+	return 0;
+}
+
+int run_tournament(const Arguments& args)
+{
+	Tournament::Options options{};
+	options.games      = args.number("games", options.games);
+	options.seed       = args.number("seed", options.seed);
+	options.maxPieces  = static_cast<uint32_t>(args.number("max-pieces", options.maxPieces));
+	options.bootstraps = args.number("bootstraps", options.bootstraps);
+	options.maxFrames  = args.number("max-frames", options.maxFrames);
+	if (args.has("versus"))
+	{
+		options.mode = Tournament::Mode::VERSUS;
+	}
+	if (args.has("garbage"))
+	{
+		options.versus.garbage = Versus::Options::parseGarbage(args.text("garbage", ""));
+	}
+	const auto versus = options.mode == Tournament::Mode::VERSUS;
+	const auto pace   = static_cast<int>(args.number("pace", 6));
+
+	ThreadPool pool{ static_cast<unsigned>(args.number("threads", 0)) };
+
+	std::vector<Entrant> entrants{};
+	const auto           players = args.text("players", versus ? "ai:depth=1,ai" : "random,ai:depth=1,ai");
+	for (size_t begin = 0; begin <= players.size();)
+	{
+		const auto end    = std::min(players.find(',', begin), players.size());
+		const auto spec   = players.substr(begin, end - begin);
+		const auto player = Arguments{ spec };
+		if (versus)
+		{
+			const auto playerPace = static_cast<int>(player.number("pace", static_cast<uint64_t>(pace)));
+			entrants.push_back(Entrant{ spec, nullptr, controller_factory(player.command(), player, pool, playerPace) });
+		}
+		else
+		{
+			entrants.push_back(Entrant{ spec, player_factory(player.command(), player, pool) });
+		}
+		begin = end + 1;
+	}
+
+	std::cout << Tournament::run(pool, options, entrants).summary();
+	return 0;
+}
+
+int run_perfect_clear(const Arguments& args)
+{
+	const auto games  = args.number("games", 100);
+	const auto seed   = args.number("seed", 1);
+	const auto pieces = args.number("pieces", 11);
+
+	auto options  = ai::PerfectClearSolver::Options{};
+	options.lines = static_cast<int>(args.number("lines", options.lines));
+	if (options.lines < 1 || options.lines > 6)
+	{
+		throw std::invalid_argument{ "--lines must be 1 to 6" };
+	}
+
+	ThreadPool             pool{ static_cast<unsigned>(args.number("threads", 0)) };
+	ai::PerfectClearSolver solver{ options, &pool };
+
+	// One game at a time, so that the times are those of a single solve on all threads.
+	std::vector<double> milliseconds{};
+	uint64_t            solved{};
+	for (uint64_t game = 0; game < games; ++game)
+	{
+		Simulation simulation{};
+		simulation.start(BatchRunner::gameSeed(seed, game));
+
+		const auto tetrominoes = ai::PerfectClearSolver::upcoming(simulation.state(), pieces);
+		const auto started     = std::chrono::steady_clock::now();
+		const auto solution    = solver.solve(simulation.board().grid(), tetrominoes);
+		milliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
+
+		if (solution)
+		{
+			// Play the solution, as a check.
+			for (const auto& placement : *solution)
+			{
+				simulation.lockAt(placement.rotation, GridPosition{ placement.row, placement.column });
+			}
+			if (simulation.board().lines() != static_cast<uint32_t>(options.lines))
+			{
+				throw std::logic_error{ "the perfect clear solution does not clear the board" };
+			}
+			++solved;
+		}
+	}
+
+	const auto time = Distribution::of(milliseconds);
+	std::cout << fmt::format("{} of {} openings have a {} line perfect clear with {} tetrominoes\n", solved, games, options.lines, pieces);
+	std::cout << fmt::format("solve ms mean {:.2f}  p50 {:.2f}  p90 {:.2f}  max {:.2f}, {} nodes on {} threads\n",
+	                         time.mean,
+	                         time.p50,
+	                         time.p90,
+	                         time.max,
+	                         solver.nodes(),
+	                         pool.size());
+	return 0;
+}
+
+int run_network(const Arguments& args)
+{
+	const auto games  = args.number("games", 64);
+	const auto seed   = args.number("seed", 1);
+	const auto pieces = args.number("pieces", 100);
+
+	const auto network = load_network(args);
+	if (args.has("save"))
+	{
+		network.save(args.text("save", ""));
+	}
+	const ai::NetworkEvaluator evaluator{ network, !args.has("scalar") };
+
+	std::vector<Simulation> simulations(games);
+	for (uint64_t game = 0; game < games; ++game)
+	{
+		simulations[game].start(BatchRunner::gameSeed(seed, game));
+	}
+
+	ai::LockstepPlayer player{ evaluator };
+	uint64_t           rounds{};
+	while (rounds < pieces && player.round(simulations.data(), simulations.size()) > 0)
+	{
+		++rounds;
+	}
+
+	std::vector<double> lines{};
+	for (const auto& simulation : simulations)
+	{
+		lines.push_back(simulation.board().lines());
+	}
+
+	const auto seconds = player.evaluatingSeconds();
+	std::cout << fmt::format("{} games, {} rounds, lines mean {:.1f}\n", games, rounds, Distribution::of(lines).mean);
+	std::cout << fmt::format("{} evaluations in {:.3f} s, {:.0f} evaluations/s with the {} kernel\n",
+	                         player.evaluations(),
+	                         seconds,
+	                         static_cast<double>(player.evaluations()) / seconds,
+	                         evaluator.vectorized() ? "AVX2" : "scalar");
+	return 0;
+}
+
+// The features the slow way, cell by cell, to measure the batch extractor against.
+int run_features(const Arguments& args)
+{
+	const auto count = args.number("grids", 100000);
+
+	// Grids from random placements, starting over when the stack gets high.
+	Xoshiro256        random{ args.number("seed", 1) };
+	ai::MoveGenerator generator{};
+	std::vector<Grid> grids{};
+	Grid              grid{};
+	while (grids.size() < count)
+	{
+		const auto  type       = static_cast<TetrominoType>(random.below(7));
+		const auto& placements = generator.generate(grid, type);
+		if (placements.empty() || grid.columnHeight(0) > 16 || grid.columnHeight(Grid::width() / 2) > 16)
+		{
+			grid = Grid{};
+			continue;
+		}
+		const auto& placement = placements[random.below(placements.size())];
+		grid.place(Tetromino{ type, placement.rotation }, GridPosition{ placement.row, placement.column });
+		grid.clearFullLines();
+		grids.push_back(grid);
+	}
 
+	std::vector<Grid::Bitboard> bitboards{};
+	for (const auto& g : grids)
+	{
+		bitboards.push_back(g.bitboard());
+	}
+
+	const auto time = [count](const char* name, const auto& extract) {
+		const auto started = std::chrono::steady_clock::now();
+		extract();
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+		std::cout << fmt::format("{:<16} {:>12.0f} grids/s\n", name, static_cast<double>(count) / seconds);
+	};
+
+	std::vector<ai::BoardFeatures> cells(count), scalar(count), vectorized(count);
+	time("cell loop", [&] {
+		for (size_t i = 0; i < count; ++i)
+		{
+			cells[i] = ai::BoardFeatures::reference(grids[i]);
+		}
+	});
+	time("batch, scalar", [&] { ai::BoardFeatures::extract(bitboards.data(), count, scalar.data(), false); });
+	time("batch, AVX2", [&] { ai::BoardFeatures::extract(bitboards.data(), count, vectorized.data()); });
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!cells[i].equals(scalar[i]) || !cells[i].equals(vectorized[i]))
+		{
+			throw std::logic_error{ fmt::format("the features of grid {} differ", i) };
+		}
+	}
+	return 0;
+}
+
+int run_allocations(const Arguments& args)
+{
+	const auto report = AllocationCheck::run(args.number("pieces", 10000), args.number("seed", 1));
+	std::cout << report.summary();
+	return report.steady == 0 ? 0 : 1;
+}
+
+int run_tune(const Arguments& args)
+{
+	auto options       = ai::WeightTuner::Options{};
+	options.population = args.number("population", options.population);
+	options.games      = args.number("games", options.games);
+	options.maxPieces  = static_cast<uint32_t>(args.number("max-pieces", options.maxPieces));
+	options.depth      = static_cast<int>(args.number("depth", options.depth));
+	options.sigma      = args.real("sigma", options.sigma);
+	options.seed       = args.number("seed", options.seed);
+	if (options.population == 1)
+	{
+		throw std::invalid_argument{ "--population must be 0, for the default, or at least 2" };
+	}
+	if (options.games == 0)
+	{
+		throw std::invalid_argument{ "--games must be at least 1" };
+	}
+	if (!(options.sigma > 0))
+	{
+		throw std::invalid_argument{ "--sigma must be positive" };
+	}
+
+	const auto generations = args.number("generations", 100);
+	const auto checkpoint  = args.text("checkpoint", "tune.checkpoint");
+	const auto output      = args.text("out", ai::HeuristicEvaluator::Weights::DEFAULT_FILE);
+
+	ThreadPool pool{ static_cast<unsigned>(args.number("threads", 0)) };
+	auto       tuner = args.has("resume") ? ai::WeightTuner{ pool, checkpoint } : ai::WeightTuner{ pool, options, load_heuristic(args) };
+
+	// A resumed run keeps the options it was started with, or it would score its candidates on other games from here on.
+	const auto& started = tuner.options();
+	if ((args.has("population") && options.population != started.population) || (args.has("games") && options.games != started.games)
+	    || (args.has("max-pieces") && options.maxPieces != started.maxPieces) || (args.has("depth") && options.depth != started.depth)
+	    || (args.has("sigma") && options.sigma != started.sigma) || (args.has("seed") && options.seed != started.seed))
+	{
+		throw std::invalid_argument{ "a resumed run keeps the options of its checkpoint: " + checkpoint };
+	}
+
+	// The checkpoint and the weights are written after every generation, so the run can be stopped at any time.
+	while (tuner.generation() < generations)
+	{
+		const auto stepped    = std::chrono::steady_clock::now();
+		const auto generation = tuner.step();
+		const auto seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - stepped).count();
+		tuner.save(checkpoint);
+		tuner.weights().save(output);
+
+		std::cout << fmt::format("generation {:>4}  best {:>8.1f}  mean {:>8.1f}  sigma {:.4f}  {:.1f} s\n",
+		                         generation.number,
+		                         generation.bestLines,
+		                         generation.meanLines,
+		                         generation.sigma,
+		                         seconds)
+		          << std::flush;
+	}
+
+	const auto weights = tuner.weights();
+	for (const auto& field : ai::HeuristicEvaluator::Weights::fields())
+	{
+		std::cout << fmt::format("{:<16} {:.6f}\n", field.first, weights.*field.second);
+	}
+	return 0;
+}
+
+bool graphical_session()
+{
 #if defined(Q_OS_WIN)
 	// On Windows, assume a graphical display is always available
-	return gui(argc, argv);
+	return true;
 #elif defined(Q_OS_MACOS)
 	// On macOS, check if we're in a graphical session
 	const auto sessionDict = CGSessionCopyCurrentDictionary();
@@ -64,26 +633,326 @@ int main(int argc, char* argv[])
 	{
 		CFRelease(sessionDict);
 	}
-	if (isGraphical)
+	return isGraphical;
+#elif defined(Q_OS_UNIX)
+	// On Unix-like systems (e.g., Linux), check if DISPLAY or WAYLAND_DISPLAY is set
+	return std::getenv("DISPLAY") != nullptr || std::getenv("WAYLAND_DISPLAY") != nullptr;
+#else
+	// For other platforms, default to TUI
+	return false;
+#endif
+}
+
+int run_replay(const Arguments& args, int argc, char* argv[])
+{
+	if (!args.has("file"))
 	{
-		return run_gui(argc, argv);
+		throw std::invalid_argument{ "replay needs --file" };
 	}
-	else
+	const auto  path   = args.text("file", "");
+	const auto  file   = std::make_shared<const ReplayFile>(path);
+	const auto& replay = file->replay();
+
+	if (args.has("save"))
 	{
-		return run_tui(argc, argv);
+		const auto out = args.text("save", "");
+		replay.save(out, args.number("keyframes", Replay::DEFAULT_KEYFRAME_SPACING));
+		std::cout << fmt::format("{}: {} keyframes, {} bytes\n", out, ReplayFile{ out }.keyframes(), std::filesystem::file_size(out));
+		return 0;
 	}
-#elif defined(Q_OS_UNIX)
-	// On Unix-like systems (e.g., Linux), check if DISPLAY or WAYLAND_DISPLAY is set
-	if (std::getenv("DISPLAY") != nullptr || std::getenv("WAYLAND_DISPLAY") != nullptr)
+
+	if (!args.has("headless"))
+	{
+		const auto speed = args.real("speed", 1);
+		if (speed <= 0)
+		{
+			throw std::invalid_argument{ "--speed must be positive" };
+		}
+		return args.has("tui") || !graphical_session() ? run_tui(argc, argv, file, speed) : run_gui(argc, argv, file, speed);
+	}
+
+	const auto repeat  = std::max<uint64_t>(args.number("repeat", 1), 1);
+	const auto started = std::chrono::steady_clock::now();
+	auto       state   = GameState{};
+	for (uint64_t i = 0; i < repeat; ++i)
 	{
-		return run_gui(argc, argv);
+		state = replay.play();
+	}
+	const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / repeat;
+
+	const auto& board   = *state.board;
+	const auto  seconds = replay.frames / Simulation::FRAMES_PER_SECOND;
+	std::cout << fmt::format("{}: {} bytes, seed {:#x}, {} inputs, {} keyframes, {}:{:02} of play\n",
+	                         path,
+	                         std::filesystem::file_size(path),
+	                         replay.seed,
+	                         replay.inputs.size(),
+	                         file->keyframes(),
+	                         seconds / 60,
+	                         seconds % 60);
+	std::cout << fmt::format("replayed score {} lines {} level {} pieces {} in {:.3f} ms\n",
+	                         board.score(),
+	                         board.lines(),
+	                         board.level(),
+	                         board.pieces(),
+	                         milliseconds);
+	std::cout << fmt::format("recorded score {} lines {} level {} pieces {}\n", replay.score, replay.lines, replay.level, replay.pieces);
+
+	if (args.has("seek"))
+	{
+		const auto frame = std::min(args.number("seek", 0), replay.frames);
+		const auto timed = [repeat](const auto& play) {
+			const auto started = std::chrono::steady_clock::now();
+			auto       state   = GameState{};
+			for (uint64_t i = 0; i < repeat; ++i)
+			{
+				state = play();
+			}
+			const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+			return std::make_pair(state, milliseconds / repeat);
+		};
+
+		// The session up to the frame, to check the seek against a simulation from the start.
+		const auto prefix = replay.until(frame);
+
+		const auto [seeked, seekMilliseconds] = timed([&]() { return file->seek(frame); });
+		const auto [played, playMilliseconds] = timed([&]() { return prefix.play(); });
+		const auto same                       = Replay::sameGame(seeked, played);
+
+		const auto& board = *seeked.board;
+		std::cout << fmt::format("frame {} ({}:{:02}): score {} lines {} level {} pieces {}, {}\n",
+		                         frame,
+		                         frame / Simulation::FRAMES_PER_SECOND / 60,
+		                         frame / Simulation::FRAMES_PER_SECOND % 60,
+		                         board.score(),
+		                         board.lines(),
+		                         board.level(),
+		                         board.pieces(),
+		                         same ? "as played from the start" : "NOT as played from the start");
+		std::cout << fmt::format("seek in {:.3f} ms, from the start in {:.3f} ms\n", seekMilliseconds, playMilliseconds);
+		return same ? 0 : 1;
+	}
+	return 0;
+}
+
+int run_verify(const Arguments& args)
+{
+	std::ifstream list{};
+	auto          source = ReplayVerifier::Source{};
+	if (args.has("dir"))
+	{
+		source = ReplayVerifier::directory(args.text("dir", ""));
+	}
+	else if (args.has("list"))
+	{
+		const auto path = args.text("list", "-");
+		if (path != "-")
+		{
+			list.open(path);
+			if (!list)
+			{
+				throw std::runtime_error{ "cannot read " + path };
+			}
+		}
+		source = ReplayVerifier::lines(path == "-" ? std::cin : list);
 	}
 	else
 	{
-		return run_tui(argc, argv);
+		throw std::invalid_argument{ "verify needs --dir or --list" };
 	}
-#else
-	// For other platforms, default to TUI
-	return run_tui(argc, argv);
-#endif
+
+	const auto failures = args.has("failures");
+	const auto sink     = [failures](const Verdict& verdict) {
+		switch (verdict.kind)
+		{
+		case Verdict::Kind::PASS:
+			if (!failures)
+			{
+				std::cout << fmt::format("PASS  {}\n", verdict.path);
+			}
+			break;
+		case Verdict::Kind::FAIL:
+			std::cout << fmt::format("FAIL  {}: {}\n", verdict.path, verdict.detail);
+			break;
+		case Verdict::Kind::ERROR:
+			std::cout << fmt::format("ERROR {}: {}\n", verdict.path, verdict.detail);
+			break;
+		}
+	};
+
+	ThreadPool pool{ static_cast<unsigned>(args.number("threads", 0)) };
+
+	const auto report = ReplayVerifier::run(pool, source, sink);
+	std::cout << report.summary();
+	return report.failed + report.errors > 0 ? 1 : 0;
+}
+
+ai::VersusGame::Options versus_options(const Arguments& args)
+{
+	auto options   = ai::VersusGame::Options{};
+	options.boards = args.number("boards", options.boards);
+	options.pace   = static_cast<int>(args.number("pace", options.pace));
+
+	if (args.has("garbage"))
+	{
+		options.versus.garbage = Versus::Options::parseGarbage(args.text("garbage", ""));
+	}
+	return options;
+}
+
+int run_versus(const Arguments& args, int argc, char* argv[])
+{
+	const auto options = versus_options(args);
+	if (options.boards < 2)
+	{
+		throw std::invalid_argument{ "--boards must be at least 2" };
+	}
+
+	if (!args.has("headless"))
+	{
+		if (options.boards > 4)
+		{
+			throw std::invalid_argument{ "--boards must be 2 to 4" };
+		}
+		return args.has("tui") || !graphical_session() ? run_tui(options) : run_gui(argc, argv, options);
+	}
+
+	auto matches      = Versus::Matches{};
+	matches.boards    = options.boards;
+	matches.count     = args.number("games", matches.count);
+	matches.seed      = args.number("seed", matches.seed);
+	matches.maxFrames = args.number("max-frames", matches.maxFrames);
+
+	ThreadPool pool{ static_cast<unsigned>(args.number("threads", 0)) };
+
+	const auto controllerFactory = controller_factory(args.text("player", "ai"), args, pool, options.pace);
+	std::cout << Versus::run(pool, matches, options.versus, controllerFactory).summary();
+	return 0;
+}
+
+int run_royale(const Arguments& args)
+{
+	const auto versus = versus_options(args);
+
+	auto options      = ai::BattleRoyale::Options{};
+	options.boards    = args.number("boards", options.boards);
+	options.seed      = args.number("seed", options.seed);
+	options.versus    = versus.versus;
+	options.pace      = versus.pace;
+	options.maxFrames = args.number("max-frames", options.maxFrames);
+	options.realTime  = args.has("real-time");
+	if (options.boards < 2)
+	{
+		throw std::invalid_argument{ "--boards must be at least 2" };
+	}
+
+	const auto targeting = args.text("targeting", "random");
+	if (targeting == "attackers")
+	{
+		options.targeting = ai::BattleRoyale::Targeting::ATTACKERS;
+	}
+	else if (targeting != "random")
+	{
+		throw std::invalid_argument{ "unknown targeting: " + targeting };
+	}
+
+	ThreadPool pool{ static_cast<unsigned>(args.number("threads", 0)) };
+
+	const auto report = ai::BattleRoyale::run(pool, options, search_factory(args.text("player", "ai"), args, pool));
+	std::cout << report.summary();
+	return report.realTimeFactor >= 1 ? 0 : 1;
+}
+
+int run_command(int argc, char* argv[])
+{
+	try
+	{
+		const Arguments args{ argc, argv };
+
+		// Headless modes play far too many games to log each one.
+		spdlog::set_level(spdlog::level::warn);
+
+		if (args.command() == "batch")
+		{
+			return run_batch(args);
+		}
+		if (args.command() == "tournament")
+		{
+			return run_tournament(args);
+		}
+		if (args.command() == "bot")
+		{
+			return run_bot(args);
+		}
+		if (args.command() == "ping")
+		{
+			return run_ping(args);
+		}
+		if (args.command() == "replay")
+		{
+			return run_replay(args, argc, argv);
+		}
+		if (args.command() == "verify")
+		{
+			return run_verify(args);
+		}
+		if (args.command() == "versus")
+		{
+			return run_versus(args, argc, argv);
+		}
+		if (args.command() == "royale")
+		{
+			return run_royale(args);
+		}
+		if (args.command() == "pc")
+		{
+			return run_perfect_clear(args);
+		}
+		if (args.command() == "nn")
+		{
+			return run_network(args);
+		}
+		if (args.command() == "features")
+		{
+			return run_features(args);
+		}
+		if (args.command() == "allocations")
+		{
+			return run_allocations(args);
+		}
+		if (args.command() == "tune")
+		{
+			return run_tune(args);
+		}
+
+		std::cerr << USAGE;
+		return 2;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>("tetris.log", false);
+	sink->set_level(spdlog::level::trace);
+
+	auto logger = std::make_shared<spdlog::logger>("", sink);
+	logger->flush_on(spdlog::level::trace);
+
+	spdlog::set_default_logger(logger);
+	spdlog::set_level(spdlog::level::trace);
+
+	// Options for Qt (-style, -platform, ...) start with a dash; anything else names a command line mode.
+	if (argc > 1 && argv[1][0] != '-')
+	{
+		return run_command(argc, argv);
+	}
+
+	return graphical_session() ? run_gui(argc, argv) : run_tui(argc, argv);
 }
@@ -1,202 +1,130 @@
 #include "playingtetromino.h"
-#include "tetromino.h"
-#include "gridposition.h"
 #include "grid.h"
+#include "rotationdirection.h"
+#include "zobrist.h"
 
+#include <type_traits>
 #include <cassert>
 
-class PlayingTetromino::impl final
-{
-	std::unique_ptr<Tetromino> tetromino_;
-	GridPosition               position_;
-	Grid&                      grid_;
-
-	void addToGrid()
-	{
-		for (const auto& offs : this->tetromino_->rotationState())
-		{
-			const auto row    = this->position_.row + offs.y;
-			const auto column = this->position_.column + offs.x;
-			assert(!this->grid_.cell(row, column).has_value());
-			this->grid_.cell(row, column) = this->tetromino_->color();
-		}
-	}
-
-	void removeFromGrid()
-	{
-		for (const auto& offs : this->tetromino_->rotationState())
-		{
-			const auto row    = this->position_.row + offs.y;
-			const auto column = this->position_.column + offs.x;
-			assert(this->grid_.cell(row, column).has_value());
-			this->grid_.cell(row, column) = std::nullopt;
-		}
-	}
+static_assert(std::is_trivially_copyable<PlayingTetromino>::value, "");
 
-	std::optional<GridPosition> tryRotation(RotationDirection direction)
-	{
-		const auto currentRotation = this->tetromino_->rotation();
+namespace {
 
-		this->tetromino_->rotate(direction);
+// A tetromino can be up to 3 rows or columns outside the grid at its top left.
+constexpr int POSITION_OFFSET = 3;
 
-		if (this->grid_.accepts(*this->tetromino_, this->position_))
-		{
-			return this->position_;
-		}
-
-		if (this->tetromino_->wallKickMap())
-		{
-			const auto& wallKickMap = this->tetromino_->wallKickMap().value().get();
-			const auto  wallKickKey = std::make_tuple(currentRotation, direction);
-			const auto  it          = wallKickMap.find(wallKickKey);
-			assert(it != wallKickMap.end());
-			const auto& wallKicks = it->second;
-			for (const auto& wallKick : wallKicks)
-			{
-				const auto position = GridPosition{ this->position_.row - wallKick.y, this->position_.column + wallKick.x };
-				if (this->grid_.accepts(*this->tetromino_, position))
-				{
-					return position;
-				}
-			}
-		}
+constexpr auto type_keys     = zobrist_keys<7>(0x7065636574797065);
+constexpr auto rotation_keys = zobrist_keys<4>(0x70656365726f7461);
+constexpr auto row_keys      = zobrist_keys<Grid::height() + POSITION_OFFSET>(0x706563657267f777);
+constexpr auto column_keys   = zobrist_keys<Grid::width() + POSITION_OFFSET>(0x70656365636f6c75);
 
-		return std::nullopt;
-	}
+} // namespace
 
-public:
-	explicit impl(std::unique_ptr<Tetromino> tetromino, GridPosition&& position, Grid& grid)
-	    : tetromino_{ std::move(tetromino) }
-	    , position_{ std::move(position) }
-	    , grid_{ grid }
-	{
-		this->addToGrid();
-	}
+std::optional<GridPosition> PlayingTetromino::tryRotation(const Grid& grid, RotationDirection direction)
+{
+	const auto currentRotation = this->tetromino_.rotation();
 
-	const Tetromino& tetromino() const
-	{
-		return *this->tetromino_;
-	}
+	this->tetromino_.rotate(direction);
 
-	const GridPosition& position() const
+	if (grid.accepts(this->tetromino_, this->position_))
 	{
 		return this->position_;
 	}
 
-	bool rotate(RotationDirection direction)
-	{
-		this->removeFromGrid();
-
-		const auto position = this->tryRotation(direction);
-
-		if (position)
-		{
-			this->position_ = position.value();
-			this->addToGrid();
-			return true;
-		}
-		else
-		{
-			this->tetromino_->rotateOpposite(direction);
-			this->addToGrid();
-			return false;
-		}
-	}
-
-	bool move(const Offset& offs)
+	if (const auto wallKickMap = this->tetromino_.wallKickMap())
 	{
-		this->removeFromGrid();
-
-		const auto position = GridPosition{ this->position_.row + offs.y, this->position_.column + offs.x };
-		if (this->grid_.accepts(*this->tetromino_, position))
+		const auto& wallKicks = (*wallKickMap)[currentRotation][rotation_direction_index(direction)];
+		for (const auto& wallKick : wallKicks)
 		{
-			this->position_ = position;
-			this->addToGrid();
-			return true;
-		}
-		else
-		{
-			this->addToGrid();
-			return false;
-		}
-	}
-
-	int hardDrop()
-	{
-		this->removeFromGrid();
-
-		int rowsDropped{};
-
-		for (;;)
-		{
-			auto position = this->position_;
-			++position.row;
-
-			if (this->grid_.accepts(*this->tetromino_, position))
+			const auto position = GridPosition{ this->position_.row - wallKick.y, this->position_.column + wallKick.x };
+			if (grid.accepts(this->tetromino_, position))
 			{
-				this->position_ = position;
-				++rowsDropped;
-			}
-			else
-			{
-				break;
+				return position;
 			}
 		}
-
-		this->addToGrid();
-
-		return rowsDropped;
 	}
 
-	bool canDescend()
-	{
-		this->removeFromGrid();
-
-		auto position = this->position_;
-		++position.row;
+	return std::nullopt;
+}
 
-		const auto result = this->grid_.accepts(*this->tetromino_, position);
+PlayingTetromino::PlayingTetromino(const Tetromino& tetromino, const GridPosition& position)
+    : tetromino_{ tetromino }
+    , position_{ position }
+{
+}
 
-		this->addToGrid();
-		return result;
-	}
-};
+const Tetromino& PlayingTetromino::tetromino() const
+{
+	return this->tetromino_;
+}
 
-PlayingTetromino::PlayingTetromino(std::unique_ptr<Tetromino> tetromino, GridPosition&& position, Grid& grid)
-    : pimpl_{ std::make_unique<impl>(std::move(tetromino), std::move(position), grid) }
+const GridPosition& PlayingTetromino::position() const
 {
+	return this->position_;
 }
 
-PlayingTetromino::~PlayingTetromino() noexcept
+bool PlayingTetromino::covers(int row, int column) const
 {
+	const auto y = row - this->position_.row;
+	const auto x = column - this->position_.column;
+	return y >= 0 && y < 4 && x >= 0 && x < 4 && (this->tetromino_.rotationMasks()[y] & (1u << x));
 }
 
-const Tetromino& PlayingTetromino::tetromino() const
+bool PlayingTetromino::rotate(const Grid& grid, RotationDirection direction)
 {
-	return this->pimpl_->tetromino();
+	const auto position = this->tryRotation(grid, direction);
+
+	if (position)
+	{
+		this->position_ = position.value();
+		return true;
+	}
+	else
+	{
+		this->tetromino_.rotateOpposite(direction);
+		return false;
+	}
 }
 
-const GridPosition& PlayingTetromino::position() const
+bool PlayingTetromino::move(const Grid& grid, const Offset& offs)
 {
-	return this->pimpl_->position();
+	const auto position = GridPosition{ this->position_.row + offs.y, this->position_.column + offs.x };
+	if (grid.accepts(this->tetromino_, position))
+	{
+		this->position_ = position;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
 }
 
-bool PlayingTetromino::rotate(RotationDirection direction)
+int PlayingTetromino::hardDrop(const Grid& grid)
 {
-	return this->pimpl_->rotate(direction);
+	const auto rowsDropped = grid.dropDistance(this->tetromino_, this->position_);
+	this->position_.row += rowsDropped;
+	return rowsDropped;
 }
 
-bool PlayingTetromino::move(const Offset& offs)
+bool PlayingTetromino::canDescend(const Grid& grid) const
 {
-	return this->pimpl_->move(offs);
+	auto position = this->position_;
+	++position.row;
+
+	return grid.accepts(this->tetromino_, position);
 }
 
-int PlayingTetromino::hardDrop()
+GridPosition PlayingTetromino::ghostPosition(const Grid& grid) const
 {
-	return this->pimpl_->hardDrop();
+	return GridPosition{ this->position_.row + grid.dropDistance(this->tetromino_, this->position_), this->position_.column };
 }
 
-bool PlayingTetromino::canDescend()
+uint64_t PlayingTetromino::hash() const
 {
-	return this->pimpl_->canDescend();
+	const auto row    = this->position_.row + POSITION_OFFSET;
+	const auto column = this->position_.column + POSITION_OFFSET;
+	assert(row >= 0 && row < static_cast<int>(row_keys.size()) && column >= 0 && column < static_cast<int>(column_keys.size()));
+	return type_keys[static_cast<int>(this->tetromino_.type())] ^ rotation_keys[this->tetromino_.rotation()] ^ row_keys[row] ^
+	       column_keys[column];
 }
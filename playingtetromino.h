@@ -1,27 +1,41 @@
 #pragma once
 
-#include <memory>
+#include "tetromino.h"
+#include "gridposition.h"
+
+#include <optional>
+#include <cstdint>
 
-class Tetromino;
-class GridPosition;
 class Grid;
 struct Offset;
 enum class RotationDirection;
 
+// The tetromino that is falling on a grid. It is an overlay: its minos are only written into the grid when it locks
+// (see Grid::place()), so moving it or probing it never touches the grid. It does not hold on to the grid it plays on,
+// which keeps it trivially copyable; every operation takes that grid as its first argument instead.
 class PlayingTetromino final
 {
-	class impl;
-	std::unique_ptr<impl> pimpl_;
+	Tetromino    tetromino_;
+	GridPosition position_;
+
+	std::optional<GridPosition> tryRotation(const Grid& grid, RotationDirection direction);
 
 public:
-	explicit PlayingTetromino(std::unique_ptr<Tetromino> tetromino, GridPosition&& position, Grid& grid);
-	~PlayingTetromino() noexcept;
+	explicit PlayingTetromino(const Tetromino& tetromino, const GridPosition& position);
 
 	const Tetromino&    tetromino() const;
 	const GridPosition& position() const;
 
-	bool rotate(RotationDirection direction);
-	bool move(const Offset& offs);
-	int  hardDrop();
-	bool canDescend();
+	bool covers(int row, int column) const;
+
+	bool rotate(const Grid& grid, RotationDirection direction);
+	bool move(const Grid& grid, const Offset& offs);
+	int  hardDrop(const Grid& grid);
+	bool canDescend(const Grid& grid) const;
+
+	// Where a hard drop would land the tetromino.
+	GridPosition ghostPosition(const Grid& grid) const;
+
+	// Zobrist hash of the type, rotation and position, to be combined with Grid::hash().
+	uint64_t hash() const;
 };
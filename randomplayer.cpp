@@ -0,0 +1,30 @@
+#include "randomplayer.h"
+#include "simulation.h"
+#include "grid.h"
+#include "inputevent.h"
+
+RandomPlayer::RandomPlayer(uint64_t seed)
+    : random_{ seed }
+{
+}
+
+void RandomPlayer::play(Simulation& simulation)
+{
+	const auto rotations = this->random_.below(4);
+	for (uint32_t i = 0; i < rotations; ++i)
+	{
+		simulation.processInputEvent(InputEvent::ROTATE_CLOCKWISE);
+	}
+
+	const auto shift = static_cast<int>(this->random_.below(Grid::width())) - Grid::width() / 2;
+	for (int i = 0; i < shift; ++i)
+	{
+		simulation.processInputEvent(InputEvent::MOVE_RIGHT);
+	}
+	for (int i = 0; i > shift; --i)
+	{
+		simulation.processInputEvent(InputEvent::MOVE_LEFT);
+	}
+
+	simulation.processInputEvent(InputEvent::HARD_DROP);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "iplayer.h"
+#include "xoshiro256.h"
+
+#include <cstdint>
+
+// Rotates, shifts and hard drops every tetromino at random. The baseline that scripted and bot players are measured against.
+class RandomPlayer final : public IPlayer
+{
+	Xoshiro256 random_;
+
+public:
+	explicit RandomPlayer(uint64_t seed);
+
+	void play(Simulation& simulation) override;
+};
@@ -0,0 +1,787 @@
+#include "replay.h"
+#include "gamestate.h"
+#include "inputevent.h"
+#include "simulation.h"
+#include "tetrominocolor.h"
+#include "tetrominotype.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char    MAGIC[4]       = { 'T', 'R', 'P', 'L' };
+constexpr char    INDEX_MAGIC[4] = { 'T', 'R', 'P', 'K' };
+constexpr uint8_t VERSION        = 2;
+constexpr uint8_t FIRST_VERSION  = 1; // without keyframes
+constexpr int     EVENT_BITS     = 3;
+constexpr int     INPUT_KINDS    = static_cast<int>(InputEvent::NEW_GAME) + 1;
+constexpr int     TETROMINOES    = static_cast<int>(TetrominoType::O) + 1;
+constexpr int     COLORS         = static_cast<int>(TetrominoColor::GREY) + 1;
+
+// The index is an entry per keyframe, then the trailer that ends the file. Both are fixed size, so that the index can be
+// searched where it lies. An entry holds the frame of the keyframe, how many inputs came before it, and where it starts;
+// the trailer holds where the index starts, the number of entries and INDEX_MAGIC.
+constexpr size_t ENTRY_SIZE   = 8 + 4 + 4;
+constexpr size_t TRAILER_SIZE = 4 + 4 + sizeof INDEX_MAGIC;
+
+static_assert(INPUT_KINDS <= 1 << EVENT_BITS, "an input event must fit in the low bits of its varint");
+static_assert(COLORS <= 16, "two colors must fit in a byte");
+
+// LEB128: seven bits per byte, least significant first, the high bit set on all bytes but the last.
+void put_varint(std::vector<uint8_t>& out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+// Zigzag: 0, -1, 1, -2... as 0, 1, 2, 3... so that small negative numbers stay short too.
+void put_signed(std::vector<uint8_t>& out, int64_t value)
+{
+	put_varint(out, static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63));
+}
+
+void put_fixed(std::vector<uint8_t>& out, uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+}
+
+uint64_t get_fixed(const uint8_t* data, int bytes)
+{
+	uint64_t value{};
+	for (int i = 0; i < bytes; ++i)
+	{
+		value |= uint64_t{ data[i] } << (8 * i);
+	}
+	return value;
+}
+
+class Reader final
+{
+	const uint8_t* data_;
+	const uint8_t* end_;
+
+public:
+	Reader(const uint8_t* data, size_t size)
+	    : data_{ data }
+	    , end_{ data + size }
+	{
+	}
+
+	uint8_t byte()
+	{
+		if (this->data_ == this->end_)
+		{
+			throw std::runtime_error{ "replay: truncated" };
+		}
+		return *this->data_++;
+	}
+
+	uint64_t varint()
+	{
+		uint64_t value{};
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			const auto b = this->byte();
+			value |= uint64_t{ b & 0x7fu } << shift;
+			if (!(b & 0x80))
+			{
+				return value;
+			}
+		}
+		throw std::runtime_error{ "replay: malformed number" };
+	}
+
+	uint32_t varint32()
+	{
+		const auto value = this->varint();
+		if (value > UINT32_MAX)
+		{
+			throw std::runtime_error{ "replay: number out of range" };
+		}
+		return static_cast<uint32_t>(value);
+	}
+
+	int64_t signedVarint()
+	{
+		const auto value = this->varint();
+		return static_cast<int64_t>(value >> 1 ^ (~(value & 1) + 1));
+	}
+
+	uint64_t fixed(int bytes)
+	{
+		uint64_t value{};
+		for (int i = 0; i < bytes; ++i)
+		{
+			value |= uint64_t{ this->byte() } << (8 * i);
+		}
+		return value;
+	}
+
+	const uint8_t* position() const
+	{
+		return this->data_;
+	}
+
+	bool done() const
+	{
+		return this->data_ == this->end_;
+	}
+};
+
+// The order of the fields follows what a Board is built from: the next tetromino first, the grid after the playing one.
+void put_state(std::vector<uint8_t>& out, const GameState& state)
+{
+	const auto& board = *state.board;
+	const auto& grid  = board.grid();
+
+	out.push_back(static_cast<uint8_t>(board.nextTetromino().type()));
+	if (const auto playingTetromino = board.playingTetromino())
+	{
+		const auto& tetromino = playingTetromino->tetromino();
+		out.push_back(static_cast<uint8_t>(static_cast<int>(tetromino.type()) + 1));
+		out.push_back(static_cast<uint8_t>(tetromino.rotation()));
+		put_signed(out, playingTetromino->position().row);
+		put_signed(out, playingTetromino->position().column);
+	}
+	else
+	{
+		out.push_back(0);
+	}
+
+	// The occupancy, then the colors of the occupied cells from the top left, two to a byte.
+	for (const auto row : grid.bitboard())
+	{
+		put_varint(out, row);
+	}
+	uint8_t colors{};
+	int     count{};
+	for (int row = 0; row < Grid::height(); ++row)
+	{
+		for (int column = 0; column < Grid::width(); ++column)
+		{
+			if (const auto cell = grid.cell(row, column))
+			{
+				colors |= static_cast<uint8_t>(static_cast<int>(*cell) << (4 * (count & 1)));
+				if (count++ & 1)
+				{
+					out.push_back(colors);
+					colors = 0;
+				}
+			}
+		}
+	}
+	if (count & 1)
+	{
+		out.push_back(colors);
+	}
+
+	put_varint(out, board.pieces());
+	put_varint(out, board.level());
+	put_varint(out, board.lines());
+	put_varint(out, board.score());
+	out.push_back(board.gameOver());
+
+	const auto bag = state.bagOfSeven.state();
+	for (const auto word : bag.random)
+	{
+		put_fixed(out, word, 8);
+	}
+	for (const auto type : bag.bag)
+	{
+		out.push_back(static_cast<uint8_t>(type));
+	}
+	out.push_back(static_cast<uint8_t>(bag.size));
+
+	put_fixed(out, state.seed, 8);
+	put_varint(out, state.frame);
+	put_varint(out, state.linesForLevelUp);
+	out.push_back(static_cast<uint8_t>(state.pendingEvent));
+	put_varint(out, static_cast<uint64_t>(state.pendingFrames));
+}
+
+std::runtime_error malformed_keyframe()
+{
+	return std::runtime_error{ "replay: malformed keyframe" };
+}
+
+TetrominoType get_type(Reader& in)
+{
+	const auto value = in.byte();
+	if (value >= TETROMINOES)
+	{
+		throw malformed_keyframe();
+	}
+	return static_cast<TetrominoType>(value);
+}
+
+GameState get_state(Reader& in)
+{
+	Board board{ get_type(in) };
+	if (const auto playing = in.byte())
+	{
+		if (playing > TETROMINOES)
+		{
+			throw malformed_keyframe();
+		}
+		const auto rotation = in.byte();
+		const auto row      = in.signedVarint();
+		const auto column   = in.signedVarint();
+		if (rotation >= 4 || row < -Grid::height() || row > Grid::height() || column < -Grid::width() || column > Grid::width())
+		{
+			throw malformed_keyframe();
+		}
+		board.setPlayingTetromino(PlayingTetromino{ Tetromino{ static_cast<TetrominoType>(playing - 1), rotation },
+		                                            GridPosition{ static_cast<int>(row), static_cast<int>(column) } });
+	}
+
+	Grid::Bitboard rows{};
+	for (auto& row : rows)
+	{
+		const auto value = in.varint();
+		if (value >= 1u << Grid::width())
+		{
+			throw malformed_keyframe();
+		}
+		row = static_cast<uint16_t>(value);
+	}
+	uint8_t colors{};
+	int     count{};
+	for (int row = 0; row < Grid::height(); ++row)
+	{
+		for (int column = 0; column < Grid::width(); ++column)
+		{
+			if (rows[row] >> column & 1)
+			{
+				if (!(count & 1))
+				{
+					colors = in.byte();
+				}
+				const auto color = colors >> (4 * (count++ & 1)) & 0xf;
+				if (color >= COLORS)
+				{
+					throw malformed_keyframe();
+				}
+				board.grid().setCell(row, column, static_cast<TetrominoColor>(color));
+			}
+		}
+	}
+	if (const auto playingTetromino = board.playingTetromino();
+	    playingTetromino && !board.grid().accepts(playingTetromino->tetromino(), playingTetromino->position()))
+	{
+		throw malformed_keyframe();
+	}
+
+	board.setPieces(in.varint32());
+	board.setLevel(in.varint32());
+	board.setLines(in.varint32());
+	board.setScore(in.varint());
+	if (in.byte())
+	{
+		board.setGameOver();
+	}
+
+	BagOfSeven::State bag{};
+	for (auto& word : bag.random)
+	{
+		word = in.fixed(8);
+	}
+	for (auto& tetromino : bag.bag)
+	{
+		tetromino = get_type(in);
+	}
+	bag.size = in.byte();
+	if (bag.size > BagOfSeven::SIZE)
+	{
+		throw malformed_keyframe();
+	}
+
+	GameState state{};
+	state.board.emplace(board);
+	state.bagOfSeven.setState(bag);
+	state.seed            = in.fixed(8);
+	state.frame           = in.varint();
+	state.linesForLevelUp = in.varint32();
+	const auto event      = in.byte();
+	const auto frames     = in.varint();
+	if (event > static_cast<uint8_t>(GameState::Event::LOCK) || frames > INT_MAX)
+	{
+		throw malformed_keyframe();
+	}
+	state.pendingEvent  = static_cast<GameState::Event>(event);
+	state.pendingFrames = static_cast<int>(frames);
+	return state;
+}
+
+// The index of a file of the current version, checked to lie inside the data, and its keyframes to lie between the inputs
+// and the index, in order of their frames.
+struct Index final
+{
+	const uint8_t* entries{};
+	size_t         count{};
+	size_t         begin{}; // of the keyframes, where the inputs end
+	size_t         end{};   // of the keyframes, where the index starts
+
+	static Index of(const uint8_t* data, size_t size)
+	{
+		if (size < TRAILER_SIZE || !std::equal(std::begin(INDEX_MAGIC), std::end(INDEX_MAGIC), data + size - sizeof INDEX_MAGIC))
+		{
+			throw std::runtime_error{ "replay: no keyframe index" };
+		}
+		Index index{};
+		index.end   = get_fixed(data + size - TRAILER_SIZE, 4);
+		index.count = get_fixed(data + size - TRAILER_SIZE + 4, 4);
+		if (index.end > size - TRAILER_SIZE || (size - TRAILER_SIZE - index.end) / ENTRY_SIZE != index.count
+		    || (size - TRAILER_SIZE - index.end) % ENTRY_SIZE != 0)
+		{
+			throw std::runtime_error{ "replay: broken keyframe index" };
+		}
+		index.entries = data + index.end;
+		index.begin   = index.count > 0 ? index.offset(0) : index.end;
+
+		for (size_t i = 1; i < index.count; ++i)
+		{
+			if (index.frame(i) <= index.frame(i - 1) || index.inputs(i) < index.inputs(i - 1) || index.offset(i) <= index.offset(i - 1))
+			{
+				throw std::runtime_error{ "replay: broken keyframe index" };
+			}
+		}
+		if (index.count > 0 && index.offset(index.count - 1) >= index.end)
+		{
+			throw std::runtime_error{ "replay: broken keyframe index" };
+		}
+		return index;
+	}
+
+	uint64_t frame(size_t i) const
+	{
+		return get_fixed(this->entries + i * ENTRY_SIZE, 8);
+	}
+
+	size_t inputs(size_t i) const
+	{
+		return get_fixed(this->entries + i * ENTRY_SIZE + 8, 4);
+	}
+
+	size_t offset(size_t i) const
+	{
+		return get_fixed(this->entries + i * ENTRY_SIZE + 12, 4);
+	}
+};
+
+} // namespace
+
+GameState Replay::play() const
+{
+	Simulation simulation{};
+	simulation.start(this->seed);
+	simulation.play(this->inputs);
+	simulation.advanceTo(this->frames);
+	return simulation.state();
+}
+
+Replay Replay::until(uint64_t frame) const
+{
+	auto prefix = *this;
+	prefix.inputs.erase(std::upper_bound(prefix.inputs.begin(),
+	                                     prefix.inputs.end(),
+	                                     frame,
+	                                     [](uint64_t f, const TimedInput& input) { return f < input.frame; }),
+	                    prefix.inputs.end());
+	prefix.frames = std::min(prefix.frames, frame);
+	return prefix;
+}
+
+bool Replay::sameGame(const GameState& a, const GameState& b)
+{
+	const auto position = [](const GameState& state) {
+		const auto playingTetromino = state.board->playingTetromino();
+		return playingTetromino ? std::make_tuple(static_cast<int>(playingTetromino->tetromino().type()),
+		                                          playingTetromino->tetromino().rotation(),
+		                                          playingTetromino->position().row,
+		                                          playingTetromino->position().column)
+		                        : std::make_tuple(-1, 0, 0, 0);
+	};
+	return a.frame == b.frame && a.board->grid().bitboard() == b.board->grid().bitboard() && position(a) == position(b)
+	    && a.board->score() == b.board->score() && a.board->lines() == b.board->lines() && a.board->level() == b.board->level()
+	    && a.board->pieces() == b.board->pieces() && a.bagOfSeven.state().random == b.bagOfSeven.state().random
+	    && a.pendingEvent == b.pendingEvent && a.pendingFrames == b.pendingFrames;
+}
+
+void Replay::setResults(const GameState& state)
+{
+	const auto& board = *state.board;
+	this->score       = board.score();
+	this->lines       = board.lines();
+	this->level       = board.level();
+	this->pieces      = board.pieces();
+}
+
+std::vector<uint8_t> Replay::encode(uint64_t keyframeSpacing) const
+{
+	std::vector<uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+	out.push_back(VERSION);
+	put_fixed(out, this->seed, 8);
+	put_varint(out, this->frames);
+	put_varint(out, this->score);
+	put_varint(out, this->lines);
+	put_varint(out, this->level);
+	put_varint(out, this->pieces);
+	put_varint(out, this->inputs.size());
+
+	uint64_t frame{};
+	for (const auto& input : this->inputs)
+	{
+		put_varint(out, (input.frame - frame) << EVENT_BITS | static_cast<uint64_t>(input.event));
+		frame = input.frame;
+	}
+
+	// Each keyframe is the state once the inputs before its frame are applied and the frame is reached, so a seek goes on
+	// from it with the inputs at its frame.
+	std::vector<uint8_t> index{};
+	uint32_t             count{};
+	if (keyframeSpacing > 0)
+	{
+		Simulation simulation{};
+		simulation.start(this->seed);
+		size_t next{};
+		for (auto keyframe = keyframeSpacing; keyframe <= this->frames; keyframe += keyframeSpacing)
+		{
+			for (; next < this->inputs.size() && this->inputs[next].frame < keyframe; ++next)
+			{
+				simulation.advanceTo(this->inputs[next].frame);
+				simulation.processInputEvent(this->inputs[next].event);
+			}
+			simulation.advanceTo(keyframe);
+			put_fixed(index, keyframe, 8);
+			put_fixed(index, next, 4);
+			put_fixed(index, out.size(), 4);
+			put_state(out, simulation.state());
+			++count;
+		}
+	}
+	if (out.size() > UINT32_MAX)
+	{
+		throw std::runtime_error{ "replay: too long" };
+	}
+	const auto indexOffset = out.size();
+	out.insert(out.end(), index.begin(), index.end());
+	put_fixed(out, indexOffset, 4);
+	put_fixed(out, count, 4);
+	out.insert(out.end(), std::begin(INDEX_MAGIC), std::end(INDEX_MAGIC));
+	return out;
+}
+
+Replay Replay::decode(const uint8_t* data, size_t size)
+{
+	Reader in{ data, size };
+	for (const auto c : MAGIC)
+	{
+		if (in.byte() != static_cast<uint8_t>(c))
+		{
+			throw std::runtime_error{ "replay: not a replay" };
+		}
+	}
+	const auto version = in.byte();
+	if (version != VERSION && version != FIRST_VERSION)
+	{
+		throw std::runtime_error{ fmt::format("replay: unknown version {}", version) };
+	}
+	// The inputs end where the keyframes begin.
+	const auto end = version == VERSION ? Index::of(data, size).begin : size;
+
+	Replay replay{};
+	replay.seed   = in.fixed(8);
+	replay.frames = in.varint();
+	replay.score  = in.varint();
+	replay.lines  = in.varint32();
+	replay.level  = in.varint32();
+	replay.pieces = in.varint32();
+
+	// Every input takes at least a byte, which bounds the count before anything is allocated for it.
+	const auto count = in.varint();
+	if (count > size)
+	{
+		throw std::runtime_error{ "replay: truncated" };
+	}
+	replay.inputs.reserve(count);
+
+	uint64_t frame{};
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		const auto value = in.varint();
+		const auto event = static_cast<int>(value & ((1u << EVENT_BITS) - 1));
+		if (event >= INPUT_KINDS)
+		{
+			throw std::runtime_error{ "replay: unknown input" };
+		}
+		const auto delta = value >> EVENT_BITS;
+		if (delta > UINT64_MAX - frame)
+		{
+			throw std::runtime_error{ "replay: inconsistent" };
+		}
+		frame += delta;
+		replay.inputs.push_back(TimedInput{ frame, static_cast<InputEvent>(event) });
+	}
+	if (replay.frames < frame || in.position() != data + end)
+	{
+		throw std::runtime_error{ "replay: inconsistent" };
+	}
+	return replay;
+}
+
+void Replay::save(const std::string& path, uint64_t keyframeSpacing) const
+{
+	const auto    data = this->encode(keyframeSpacing);
+	std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+	out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	if (!out)
+	{
+		throw std::runtime_error{ "cannot write replay: " + path };
+	}
+}
+
+Replay Replay::load(const std::string& path)
+{
+	std::ifstream in{ path, std::ios::binary };
+	if (!in)
+	{
+		throw std::runtime_error{ "cannot read replay: " + path };
+	}
+	// In one read rather than a byte at a time.
+	in.seekg(0, std::ios::end);
+	std::vector<uint8_t> data(static_cast<size_t>(std::max<std::streamoff>(in.tellg(), 0)));
+	in.seekg(0, std::ios::beg);
+	in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	if (!in)
+	{
+		throw std::runtime_error{ "cannot read replay: " + path };
+	}
+	return decode(data.data(), data.size());
+}
+
+void Replay::archive() const noexcept
+{
+	try
+	{
+		const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+		char       name[32];
+		std::strftime(name, sizeof name, "%Y-%m-%d_%H-%M-%S", std::localtime(&now));
+
+		std::filesystem::create_directories("replays");
+		const auto path = fmt::format("replays/{}.replay", name);
+		this->save(path);
+		spdlog::info("session saved to {}", path);
+	}
+	catch (const std::exception& e)
+	{
+		spdlog::error("cannot save the session: {}", e.what());
+	}
+}
+
+class ReplayFile::impl final
+{
+	const uint8_t*       data_{};
+	size_t               size_{};
+	std::vector<uint8_t> buffer_{}; // the file, where it cannot be mapped
+	Replay               replay_{};
+	Index                index_{};
+
+	void map(const std::string& path);
+	void unmap() noexcept;
+
+public:
+	explicit impl(const std::string& path)
+	{
+		this->map(path);
+		try
+		{
+			this->replay_ = Replay::decode(this->data_, this->size_);
+			if (this->data_[sizeof MAGIC] == VERSION)
+			{
+				this->index_ = Index::of(this->data_, this->size_);
+			}
+			// A keyframe comes after the inputs before its frame, and before the rest.
+			const auto& inputs = this->replay_.inputs;
+			for (size_t i = 0; i < this->index_.count; ++i)
+			{
+				const auto frame = this->index_.frame(i);
+				const auto next  = this->index_.inputs(i);
+				if (frame > this->replay_.frames || next > inputs.size() || (next > 0 && inputs[next - 1].frame >= frame)
+				    || (next < inputs.size() && inputs[next].frame < frame))
+				{
+					throw std::runtime_error{ "replay: broken keyframe index" };
+				}
+			}
+		}
+		catch (const std::exception&)
+		{
+			this->unmap();
+			throw;
+		}
+	}
+
+	~impl() noexcept
+	{
+		this->unmap();
+	}
+
+	const Replay& replay() const
+	{
+		return this->replay_;
+	}
+
+	size_t keyframes() const
+	{
+		return this->index_.count;
+	}
+
+	GameState seek(uint64_t frame) const
+	{
+		frame = std::min(frame, this->replay_.frames);
+
+		// The number of keyframes at or before the frame.
+		size_t low = 0, high = this->index_.count;
+		while (low < high)
+		{
+			const auto middle = (low + high) / 2;
+			if (this->index_.frame(middle) <= frame)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		Simulation simulation{};
+		size_t     next{};
+		if (low > 0)
+		{
+			const auto offset = this->index_.offset(low - 1);
+			Reader     in{ this->data_ + offset, this->index_.end - offset };
+			const auto state = get_state(in);
+			if (state.frame != this->index_.frame(low - 1))
+			{
+				throw malformed_keyframe();
+			}
+			simulation.restore(state);
+			next = this->index_.inputs(low - 1);
+		}
+		else
+		{
+			simulation.start(this->replay_.seed);
+		}
+
+		const auto& inputs = this->replay_.inputs;
+		for (; next < inputs.size() && inputs[next].frame <= frame; ++next)
+		{
+			simulation.advanceTo(inputs[next].frame);
+			simulation.processInputEvent(inputs[next].event);
+		}
+		simulation.advanceTo(std::max(frame, simulation.frame()));
+		return simulation.state();
+	}
+};
+
+void ReplayFile::impl::map(const std::string& path)
+{
+#ifdef _WIN32
+	std::ifstream in{ path, std::ios::binary };
+	if (!in)
+	{
+		throw std::runtime_error{ "cannot read replay: " + path };
+	}
+	this->buffer_.assign(std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{});
+	this->data_ = this->buffer_.data();
+	this->size_ = this->buffer_.size();
+#else
+	const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		throw std::runtime_error{ "cannot read replay: " + path };
+	}
+	struct stat status{};
+	if (fstat(fd, &status) != 0)
+	{
+		close(fd);
+		throw std::runtime_error{ "cannot read replay: " + path };
+	}
+	this->size_ = static_cast<size_t>(status.st_size);
+	if (this->size_ == 0)
+	{
+		// Nothing to map, and decoding it fails as it should.
+		close(fd);
+		this->data_ = this->buffer_.data();
+		return;
+	}
+	const auto mapping = mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		throw std::runtime_error{ "cannot map replay: " + path };
+	}
+	this->data_ = static_cast<const uint8_t*>(mapping);
+#endif
+}
+
+void ReplayFile::impl::unmap() noexcept
+{
+#ifndef _WIN32
+	if (this->size_ > 0)
+	{
+		munmap(const_cast<uint8_t*>(this->data_), this->size_);
+	}
+#endif
+	this->data_ = nullptr;
+	this->size_ = 0;
+}
+
+ReplayFile::ReplayFile(const std::string& path)
+    : pimpl_{ std::make_unique<impl>(path) }
+{
+}
+
+ReplayFile::~ReplayFile() noexcept
+{
+}
+
+const Replay& ReplayFile::replay() const
+{
+	return this->pimpl_->replay();
+}
+
+size_t ReplayFile::keyframes() const
+{
+	return this->pimpl_->keyframes();
+}
+
+GameState ReplayFile::seek(uint64_t frame) const
+{
+	return this->pimpl_->seek(frame);
+}
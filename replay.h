@@ -0,0 +1,81 @@
+#pragma once
+
+#include "timedinput.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct GameState;
+
+// A recorded session: the seed of its first game and every input at the frame it was made. The game rules are
+// deterministic on the frame clock, and a new game is seeded from the last one, so these reproduce the whole session.
+//
+// The file is the header, then one varint per input holding the frames since the input before it and the input event,
+// so an input costs a byte unless it comes more than 15 frames after the last. A ten minute game is a few kilobytes.
+//
+// After the inputs come keyframes, snapshots of the game state at every so many frames, and an index of them at the end
+// of the file, so that a viewer can jump into a long session without simulating all of it (see ReplayFile). A keyframe
+// takes about 140 bytes with its index entry; the spacing trades the size of the file against how many frames a seek
+// simulates at most.
+struct Replay final
+{
+	static constexpr uint64_t DEFAULT_KEYFRAME_SPACING = 10 * 60; // frames
+
+	uint64_t                seed{};
+	std::vector<TimedInput> inputs{}; // sorted by frame
+	uint64_t                frames{}; // where the recording ends, at or after the last input
+
+	// What the last game of the session ended with, by the account of the recorder, for checking the replay against.
+	uint64_t score{};
+	uint32_t lines{}, level{}, pieces{};
+
+	// Plays the session headless, as fast as the simulation skips from event to event, and returns the state at its end.
+	GameState play() const;
+
+	// The session cut off at the frame, with the inputs made at or before it.
+	Replay until(uint64_t frame) const;
+
+	// Whether the states hold the same position, results and future, which is what checking a seek needs.
+	static bool sameGame(const GameState& a, const GameState& b);
+
+	// Takes the claimed results from the state a session ended in.
+	void setResults(const GameState& state);
+
+	// Plays the session headless once more, for the keyframes. A spacing of 0 writes none.
+	std::vector<uint8_t> encode(uint64_t keyframeSpacing = DEFAULT_KEYFRAME_SPACING) const;
+	// Throws std::runtime_error when the data is not a replay. Skips the keyframes.
+	static Replay decode(const uint8_t* data, size_t size);
+
+	// Throw std::runtime_error when the file cannot be written or read.
+	void          save(const std::string& path, uint64_t keyframeSpacing = DEFAULT_KEYFRAME_SPACING) const;
+	static Replay load(const std::string& path);
+
+	// Saves a session of the interactive game under replays/ in the working directory, named after the current time.
+	// Logs rather than throws when that fails, as it happens while the game closes.
+	void archive() const noexcept;
+};
+
+// A replay file mapped into memory, for a viewer that jumps around in it. The inputs are decoded once; a seek looks up
+// the last keyframe at or before the frame in the index, restores it straight from the mapping, and simulates the
+// frames from there. Files of the first version, which have no keyframes, seek from the start of the session.
+class ReplayFile final
+{
+	class impl;
+	std::unique_ptr<impl> pimpl_;
+
+public:
+	// Throws std::runtime_error when the file cannot be read or is not a replay.
+	explicit ReplayFile(const std::string& path);
+	~ReplayFile() noexcept;
+
+	const Replay& replay() const;
+
+	size_t keyframes() const;
+
+	// The state at the frame, once every input made at or before it has been applied, as the playback shows it. Frames
+	// past the end of the recording seek to its end.
+	GameState seek(uint64_t frame) const;
+};
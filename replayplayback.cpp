@@ -0,0 +1,79 @@
+#include "replayplayback.h"
+#include "itimer.h"
+
+#include <algorithm>
+
+ReplayPlayback::ReplayPlayback(std::shared_ptr<const ReplayFile> file,
+                               std::function<void()>             onUpdate,
+                               std::unique_ptr<ITimer>           timer,
+                               double                            speed)
+    : file_{ std::move(file) }
+    , simulation_{ std::move(onUpdate) }
+    , timer_{ std::move(timer) }
+    , speed_{ speed }
+{
+}
+
+ReplayPlayback::~ReplayPlayback() noexcept
+{
+	this->timer_->stop();
+}
+
+void ReplayPlayback::start()
+{
+	this->simulation_.start(this->file_->replay().seed);
+	this->next_    = 0;
+	this->started_ = Clock::now();
+	this->tick();
+}
+
+void ReplayPlayback::seek(uint64_t frame)
+{
+	const auto& replay = this->file_->replay();
+	frame              = std::min(frame, replay.frames);
+
+	this->timer_->stop();
+	this->simulation_.restore(this->file_->seek(frame));
+	const auto after = std::upper_bound(replay.inputs.begin(), replay.inputs.end(), frame, [](uint64_t f, const TimedInput& input) {
+		return f < input.frame;
+	});
+	const auto seconds = static_cast<double>(frame) / (this->speed_ * Simulation::FRAMES_PER_SECOND);
+	this->next_        = static_cast<size_t>(after - replay.inputs.begin());
+	this->started_     = Clock::now() - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+	this->tick();
+}
+
+uint64_t ReplayPlayback::frame() const
+{
+	return this->simulation_.frame();
+}
+
+void ReplayPlayback::tick()
+{
+	const auto  elapsed = std::chrono::duration<double>(Clock::now() - this->started_).count();
+	const auto& replay  = this->file_->replay();
+	const auto  frame   = std::min(static_cast<uint64_t>(elapsed * this->speed_ * Simulation::FRAMES_PER_SECOND), replay.frames);
+
+	const auto& inputs = replay.inputs;
+	for (; this->next_ < inputs.size() && inputs[this->next_].frame <= frame; ++this->next_)
+	{
+		this->simulation_.advanceTo(inputs[this->next_].frame);
+		this->simulation_.processInputEvent(inputs[this->next_].event);
+	}
+	this->simulation_.advanceTo(std::max(frame, this->simulation_.frame()));
+
+	if (!this->finished())
+	{
+		this->timer_->start(TICK_MSEC, [this]() { this->tick(); });
+	}
+}
+
+const Board& ReplayPlayback::board() const
+{
+	return this->simulation_.board();
+}
+
+bool ReplayPlayback::finished() const
+{
+	return this->simulation_.frame() >= this->file_->replay().frames;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "replay.h"
+#include "simulation.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+class Board;
+class ITimer;
+
+// Plays a replay back at real speed, or a multiple of it, for a renderer to draw. The wall clock only decides which frame
+// the simulation should have reached by now; the inputs are applied at the frames they were recorded at, so the
+// playback is the recorded session however late the timer fires. Seeking goes through the keyframes of the file.
+class ReplayPlayback final
+{
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr int TICK_MSEC = 1000 / Simulation::FRAMES_PER_SECOND;
+
+	std::shared_ptr<const ReplayFile> file_;
+	Simulation                        simulation_;
+	std::unique_ptr<ITimer>           timer_;
+	double                            speed_;
+	size_t                            next_{};
+	Clock::time_point                 started_{};
+
+	void tick();
+
+public:
+	// How far the viewers jump back or forward at a key press.
+	static constexpr uint64_t SEEK_STEP = 10 * Simulation::FRAMES_PER_SECOND;
+
+	ReplayPlayback(std::shared_ptr<const ReplayFile> file, std::function<void()> onUpdate, std::unique_ptr<ITimer> timer, double speed = 1);
+	~ReplayPlayback() noexcept;
+
+	void start();
+
+	// Goes on playing from the frame, back or forward.
+	void     seek(uint64_t frame);
+	uint64_t frame() const;
+
+	const Board& board() const;
+
+	bool finished() const;
+};
@@ -0,0 +1,140 @@
+#include "replayverifier.h"
+#include "gamestate.h"
+#include "replay.h"
+#include "threadpool.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <istream>
+#include <memory>
+#include <vector>
+
+std::string VerificationReport::summary() const
+{
+	return fmt::format("{} replays on {} threads in {:.3f} s: {} passed, {} failed, {} unreadable\n{:.1f} replays/s\n",
+	                   this->passed + this->failed + this->errors,
+	                   this->threads,
+	                   this->seconds,
+	                   this->passed,
+	                   this->failed,
+	                   this->errors,
+	                   this->replaysPerSecond);
+}
+
+Verdict ReplayVerifier::verify(const std::string& path)
+{
+	Verdict verdict{ path };
+	try
+	{
+		const auto  replay = Replay::load(path);
+		const auto  state  = replay.play();
+		const auto& board  = *state.board;
+
+		std::string differences{};
+		const auto  compare = [&differences](const char* name, uint64_t replayed, uint64_t claimed) {
+			if (replayed != claimed)
+			{
+				differences += fmt::format("{}{} {}, claimed {}", differences.empty() ? "" : "; ", name, replayed, claimed);
+			}
+		};
+		compare("score", board.score(), replay.score);
+		compare("lines", board.lines(), replay.lines);
+		compare("level", board.level(), replay.level);
+		if (!differences.empty())
+		{
+			verdict.kind   = Verdict::Kind::FAIL;
+			verdict.detail = std::move(differences);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		verdict.kind   = Verdict::Kind::ERROR;
+		verdict.detail = e.what();
+	}
+	return verdict;
+}
+
+VerificationReport ReplayVerifier::run(ThreadPool& pool, const Source& source, const Sink& sink)
+{
+	VerificationReport report{};
+	report.threads = pool.size();
+
+	const auto started = std::chrono::steady_clock::now();
+
+	std::vector<std::string> paths{};
+	std::vector<Verdict>     verdicts{};
+	for (bool more = true; more;)
+	{
+		paths.clear();
+		while (paths.size() < WINDOW)
+		{
+			auto path = source();
+			if (!path)
+			{
+				more = false;
+				break;
+			}
+			paths.push_back(std::move(*path));
+		}
+
+		verdicts.assign(paths.size(), Verdict{});
+		pool.parallelFor(paths.size(), [&](size_t i) { verdicts[i] = verify(paths[i]); });
+
+		for (const auto& verdict : verdicts)
+		{
+			switch (verdict.kind)
+			{
+			case Verdict::Kind::PASS:
+				++report.passed;
+				break;
+			case Verdict::Kind::FAIL:
+				++report.failed;
+				break;
+			case Verdict::Kind::ERROR:
+				++report.errors;
+				break;
+			}
+			sink(verdict);
+		}
+	}
+
+	report.seconds          = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+	report.replaysPerSecond = (report.passed + report.failed + report.errors) / std::max(report.seconds, 1e-9);
+	return report;
+}
+
+ReplayVerifier::Source ReplayVerifier::directory(const std::string& path)
+{
+	const auto it = std::make_shared<std::filesystem::recursive_directory_iterator>(path);
+	return [it]() -> std::optional<std::string> {
+		for (; *it != std::filesystem::recursive_directory_iterator{}; ++*it)
+		{
+			const auto& entry = **it;
+			if (entry.is_regular_file() && entry.path().extension() == ".replay")
+			{
+				auto path = entry.path().string();
+				++*it;
+				return path;
+			}
+		}
+		return std::nullopt;
+	};
+}
+
+ReplayVerifier::Source ReplayVerifier::lines(std::istream& in)
+{
+	return [&in]() -> std::optional<std::string> {
+		std::string line{};
+		while (std::getline(in, line))
+		{
+			if (!line.empty())
+			{
+				return line;
+			}
+		}
+		return std::nullopt;
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <cstddef>
+
+class ThreadPool;
+
+struct Verdict final
+{
+	enum class Kind
+	{
+		PASS,
+		FAIL, // the replay plays to other results than it claims
+		ERROR // the file cannot be read or is not a replay
+	};
+
+	std::string path{};
+	Kind        kind{ Kind::PASS };
+	std::string detail{}; // what differs, or why the file was not verified
+};
+
+struct VerificationReport final
+{
+	size_t   passed{}, failed{}, errors{};
+	unsigned threads{};
+	double   seconds{};
+	double   replaysPerSecond{};
+
+	std::string summary() const;
+};
+
+// Checks the results that submitted replays claim by playing them again headless. Only the seed and the inputs are
+// trusted: the keyframes of a replay are claims as much as its results, so every session is simulated from its start.
+//
+// The paths come from a source and are verified a window at a time, spread over the pool, so however many replays there
+// are, only the paths and verdicts of a window and the replay each thread is playing are in memory.
+class ReplayVerifier final
+{
+public:
+	static constexpr size_t WINDOW = 4096;
+
+	// The next path, or nullopt at the end.
+	using Source = std::function<std::optional<std::string>()>;
+	using Sink   = std::function<void(const Verdict&)>;
+
+	static Verdict verify(const std::string& path);
+
+	// Passes the verdicts to the sink on the calling thread, in the order of the source.
+	static VerificationReport run(ThreadPool& pool, const Source& source, const Sink& sink);
+
+	// The .replay files under a directory and its subdirectories, in no particular order.
+	static Source directory(const std::string& path);
+	// A path per line. The stream must outlive the source.
+	static Source lines(std::istream& in);
+};
@@ -5,3 +5,9 @@ enum class RotationDirection : int
 	CLOCKWISE         = 1,
 	COUNTER_CLOCKWISE = -1
 };
+
+// Index of a rotation direction in tables that hold one entry per direction.
+constexpr int rotation_direction_index(RotationDirection direction)
+{
+	return direction == RotationDirection::CLOCKWISE ? 0 : 1;
+}
@@ -0,0 +1,385 @@
+#include "simulation.h"
+#include "grid.h"
+#include "offset.h"
+#include "rotationdirection.h"
+#include "inputevent.h"
+#include "playingtetromino.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+#include <cassert>
+
+static_assert(std::is_trivially_copyable<GameState>::value, "");
+
+void Simulation::update()
+{
+	if (this->onUpdate_)
+	{
+		this->onUpdate_();
+	}
+}
+
+void Simulation::reset()
+{
+	this->state_.board.emplace(this->state_.bagOfSeven.next());
+	this->state_.board->moveNextTetrominoToGrid(this->state_.bagOfSeven.next());
+	this->state_.linesForLevelUp = LINES_LEVEL_UP;
+	this->update();
+	this->scheduleDescent();
+}
+
+int Simulation::descendInterval() const
+{
+	const auto level = this->state_.board->level();
+	if (level >= 19)
+	{
+		return 4;
+	}
+	else if (level >= 9)
+	{
+		return 6;
+	}
+	else
+	{
+		return 48 - 5 * level;
+	}
+}
+
+void Simulation::schedule(GameState::Event event, int frames)
+{
+	assert(frames > 0);
+	this->state_.pendingEvent  = event;
+	this->state_.pendingFrames = frames;
+}
+
+void Simulation::scheduleDescent()
+{
+	this->schedule(GameState::Event::DESCEND, this->descendInterval());
+}
+
+void Simulation::scheduleLock()
+{
+	if (this->state_.pendingEvent != GameState::Event::LOCK)
+	{
+		this->schedule(GameState::Event::LOCK, LOCKING_DELAY);
+	}
+}
+
+void Simulation::fire()
+{
+	const auto event          = this->state_.pendingEvent;
+	this->state_.pendingEvent = GameState::Event::NONE;
+	switch (event)
+	{
+	case GameState::Event::NONE:
+		break;
+	case GameState::Event::DESCEND:
+		// Gravity keeps ticking until something else is scheduled.
+		this->scheduleDescent();
+		return this->descend();
+	case GameState::Event::LOCK:
+		return this->lock();
+	}
+}
+
+void Simulation::descend()
+{
+	auto playingTetromino = this->state_.board->playingTetromino();
+	if (playingTetromino)
+	{
+		const auto changed = playingTetromino->move(this->state_.board->grid(), Offset{ 0, +1 });
+		if (changed)
+		{
+			this->afterChange();
+		}
+	}
+}
+
+void Simulation::lock()
+{
+	this->state_.board->lockPlayingTetromino();
+	const auto linesCleared = this->clearFullLines();
+
+	if (this->onLock_)
+	{
+		this->onLock_(linesCleared);
+		if (this->state_.board->gameOver())
+		{
+			return;
+		}
+	}
+
+	if (!this->state_.board->moveNextTetrominoToGrid(this->state_.bagOfSeven.next()))
+	{
+		return gameOver();
+	}
+
+	this->afterChange();
+}
+
+void Simulation::afterChange()
+{
+	auto playingTetromino = this->state_.board->playingTetromino();
+	if (playingTetromino)
+	{
+		if (playingTetromino->canDescend(this->state_.board->grid()))
+		{
+			this->scheduleDescent();
+		}
+		else
+		{
+			this->scheduleLock();
+		}
+
+		this->update();
+	}
+}
+
+int Simulation::clearFullLines()
+{
+	const auto linesCleared = this->state_.board->grid().clearFullLines();
+	if (linesCleared)
+	{
+		int score{};
+		switch (linesCleared)
+		{
+		case 1:
+			score = 40;
+			break;
+		case 2:
+			score = 100;
+			break;
+		case 3:
+			score = 300;
+			break;
+		case 4:
+			score = 1200;
+			break;
+		default:
+			throw std::runtime_error{ "should not happen" };
+		}
+		score *= (this->state_.board->level() + 1);
+		this->state_.board->addScore(score);
+	}
+
+	const auto totalLinesCleared = this->state_.board->lines() + linesCleared;
+	this->state_.board->setLines(totalLinesCleared);
+
+	while (totalLinesCleared >= this->state_.linesForLevelUp)
+	{
+		this->levelUp();
+		this->state_.linesForLevelUp += LINES_LEVEL_UP;
+	}
+	return linesCleared;
+}
+
+void Simulation::levelUp()
+{
+	this->state_.board->setLevel(this->state_.board->level() + 1);
+}
+
+void Simulation::gameOver()
+{
+	spdlog::info("GAME OVER");
+	this->state_.board->setGameOver();
+	this->state_.pendingEvent = GameState::Event::NONE;
+	this->update();
+}
+
+void Simulation::newGame()
+{
+	if (this->state_.board->gameOver())
+	{
+		// Derive the next game's seed from this one, so that a whole session replays from its first seed.
+		this->start(Xoshiro256{ this->state_.seed }());
+	}
+}
+
+Simulation::Simulation(std::function<void()> onUpdate)
+    : onUpdate_{ onUpdate }
+{
+}
+
+void Simulation::start(uint64_t seed)
+{
+	this->state_.seed = seed;
+	this->state_.bagOfSeven.seed(seed);
+	this->reset();
+}
+
+void Simulation::start()
+{
+	this->start(BagOfSeven::randomSeed());
+}
+
+uint64_t Simulation::seed() const
+{
+	return this->state_.seed;
+}
+
+Board& Simulation::board()
+{
+	return *this->state_.board;
+}
+
+const Board& Simulation::board() const
+{
+	return *this->state_.board;
+}
+
+uint64_t Simulation::frame() const
+{
+	return this->state_.frame;
+}
+
+const GameState& Simulation::state() const
+{
+	return this->state_;
+}
+
+void Simulation::restore(const GameState& state)
+{
+	this->state_ = state;
+	this->update();
+}
+
+std::optional<int> Simulation::framesToNextEvent() const
+{
+	if (this->state_.pendingEvent == GameState::Event::NONE)
+	{
+		return std::nullopt;
+	}
+	return this->state_.pendingFrames;
+}
+
+void Simulation::processInputEvent(InputEvent event)
+{
+	if (this->recording_)
+	{
+		this->recording_->push_back(TimedInput{ this->state_.frame, event });
+	}
+
+	auto playingTetromino = this->state_.board->playingTetromino();
+	if (playingTetromino)
+	{
+		auto& grid    = this->state_.board->grid();
+		auto  changed = false;
+
+		switch (event)
+		{
+		case InputEvent::MOVE_LEFT:
+			changed = playingTetromino->move(grid, Offset{ -1, 0 });
+			break;
+		case InputEvent::MOVE_RIGHT:
+			changed = playingTetromino->move(grid, Offset{ +1, 0 });
+			break;
+		case InputEvent::SOFT_DROP:
+			changed = playingTetromino->move(grid, Offset{ 0, +1 });
+			if (changed)
+			{
+				this->state_.board->addScore(SOFT_DROP_SCORE);
+			}
+			break;
+		case InputEvent::HARD_DROP:
+		{
+			const auto rowsDropped = playingTetromino->hardDrop(grid);
+			changed                = rowsDropped > 0;
+			if (changed)
+			{
+				this->state_.board->addScore(HARD_DROP_SCORE * rowsDropped);
+				return this->lock();
+			}
+			break;
+		}
+		case InputEvent::ROTATE_CLOCKWISE:
+			changed = playingTetromino->rotate(grid, RotationDirection::CLOCKWISE);
+			break;
+		case InputEvent::ROTATE_COUNTER_CLOCKWISE:
+			changed = playingTetromino->rotate(grid, RotationDirection::COUNTER_CLOCKWISE);
+			break;
+		case InputEvent::NEW_GAME:
+			return this->newGame();
+		}
+
+		if (changed)
+		{
+			this->afterChange();
+		}
+	}
+	else if (event == InputEvent::NEW_GAME)
+	{
+		return this->newGame();
+	}
+}
+
+void Simulation::record(std::vector<TimedInput>* inputs)
+{
+	this->recording_ = inputs;
+}
+
+void Simulation::setLockHandler(std::function<void(int linesCleared)> onLock)
+{
+	this->onLock_ = std::move(onLock);
+}
+
+void Simulation::raiseGarbage(int rows, int holeColumn)
+{
+	assert(!this->state_.board->playingTetromino());
+	if (!this->state_.board->grid().insertGarbage(rows, holeColumn))
+	{
+		this->gameOver();
+	}
+}
+
+void Simulation::lockAt(Rotation rotation, const GridPosition& position)
+{
+	auto playingTetromino = this->state_.board->playingTetromino();
+	assert(playingTetromino);
+
+	*playingTetromino = PlayingTetromino{ Tetromino{ playingTetromino->tetromino().type(), rotation }, position };
+	assert(this->state_.board->grid().accepts(playingTetromino->tetromino(), position));
+	assert(!playingTetromino->canDescend(this->state_.board->grid()));
+
+	this->state_.pendingEvent = GameState::Event::NONE;
+	this->lock();
+}
+
+void Simulation::advance(uint64_t frames)
+{
+	while (frames > 0)
+	{
+		if (this->state_.pendingEvent == GameState::Event::NONE)
+		{
+			this->state_.frame += frames;
+			return;
+		}
+
+		const auto step = std::min<uint64_t>(frames, this->state_.pendingFrames);
+		this->state_.frame += step;
+		this->state_.pendingFrames -= static_cast<int>(step);
+		frames -= step;
+
+		if (this->state_.pendingFrames == 0)
+		{
+			this->fire();
+		}
+	}
+}
+
+void Simulation::advanceTo(uint64_t frame)
+{
+	assert(frame >= this->state_.frame);
+	this->advance(frame - this->state_.frame);
+}
+
+void Simulation::play(const std::vector<TimedInput>& inputs)
+{
+	for (const auto& input : inputs)
+	{
+		this->advanceTo(input.frame);
+		this->processInputEvent(input.event);
+	}
+}
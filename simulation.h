@@ -0,0 +1,93 @@
+#pragma once
+
+#include "gamestate.h"
+#include "timedinput.h"
+
+#include <functional>
+#include <optional>
+#include <vector>
+#include <cstdint>
+
+enum class InputEvent;
+
+// The game rules on a fixed frame clock instead of wall-clock timers. Gravity and the locking delay are counted in frames,
+// and nothing happens between the scheduled events, so advancing by any number of frames only costs the events that fall
+// inside them. A Simulation needs no event loop, and the real-time Game is a thin driver around one, so both produce the
+// same game for the same inputs at the same frames.
+class Simulation final
+{
+public:
+	static constexpr int FRAMES_PER_SECOND = 60;
+
+private:
+	static constexpr uint32_t LINES_LEVEL_UP  = 10;
+	static constexpr int      LOCKING_DELAY   = 30; // 500 ms
+	static constexpr int      SOFT_DROP_SCORE = 1;
+	static constexpr int      HARD_DROP_SCORE = 2;
+
+	std::function<void()>    onUpdate_;
+	std::function<void(int)> onLock_{};
+	GameState                state_{};
+	std::vector<TimedInput>* recording_{};
+
+	void update();
+	void reset();
+
+	int descendInterval() const;
+
+	void schedule(GameState::Event event, int frames);
+	void scheduleDescent();
+	void scheduleLock();
+	void fire();
+
+	void descend();
+	void lock();
+	void afterChange();
+	int  clearFullLines();
+	void levelUp();
+	void gameOver();
+	void newGame();
+
+public:
+	explicit Simulation(std::function<void()> onUpdate = {});
+
+	// The seed fully determines the tetromino sequence, so the seed and the timed inputs fully determine the game.
+	void start(uint64_t seed);
+	void start();
+
+	uint64_t seed() const;
+
+	Board&       board();
+	const Board& board() const;
+
+	uint64_t frame() const;
+
+	// Frames until the next gravity or lock event, if one is scheduled.
+	std::optional<int> framesToNextEvent() const;
+
+	const GameState& state() const;
+	void             restore(const GameState& state);
+
+	void processInputEvent(InputEvent event);
+
+	// From now on appends every input to the given list, at the frame it is made, for a replay. nullptr stops recording.
+	void record(std::vector<TimedInput>* inputs);
+
+	// For versus: called at every lock with the number of lines it cleared, before the next tetromino enters, which is
+	// when garbage rises.
+	void setLockHandler(std::function<void(int linesCleared)> onLock);
+
+	// Raises rows of garbage from the bottom of the grid (see Grid::insertGarbage()), and tops the game out when that pushes
+	// minos out at the top. Only from the lock handler, while no tetromino is playing.
+	void raiseGarbage(int rows, int holeColumn);
+
+	// For searches: puts the playing tetromino straight at a position where it cannot descend any further, and locks it
+	// there, skipping the inputs and frames that would take it there.
+	void lockAt(Rotation rotation, const GridPosition& position);
+
+	void advance(uint64_t frames);
+	void advanceTo(uint64_t frame);
+
+	// Applies each input at its frame. The inputs must be sorted by frame, and none may lie in the past.
+	void play(const std::vector<TimedInput>& inputs);
+};
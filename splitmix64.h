@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+// SplitMix64 by Sebastiano Vigna: advances x and returns a well mixed word of it. Seeds xoshiro256** and generates the
+// Zobrist keys, in constant expressions too.
+constexpr uint64_t splitmix64(uint64_t& x)
+{
+	uint64_t z = (x += 0x9e3779b97f4a7c15);
+	z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z          = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
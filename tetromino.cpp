@@ -4,74 +4,139 @@
 
 #include <cassert>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 
 namespace {
 
-using TetrominoColorMapType = std::map<TetrominoType, TetrominoColor>;
+static_assert(std::is_trivially_copyable<Tetromino>::value, "");
 
-const TetrominoColorMapType& tetromino_color_map()
+constexpr int TETROMINO_TYPES = 7;
+
+constexpr int type_index(TetrominoType type)
 {
-	static const TetrominoColorMapType _{ { TetrominoType::J, TetrominoColor::BLUE },  { TetrominoType::L, TetrominoColor::ORANGE },
-		                                  { TetrominoType::S, TetrominoColor::GREEN }, { TetrominoType::T, TetrominoColor::PURPLE },
-		                                  { TetrominoType::Z, TetrominoColor::RED },   { TetrominoType::I, TetrominoColor::CYAN },
-		                                  { TetrominoType::O, TetrominoColor::YELLOW } };
-	return _;
+	return static_cast<int>(type);
 }
 
-TetrominoColor tetromino_color(TetrominoType type)
+static_assert(type_index(TetrominoType::J) == 0, "tables below are in TetrominoType order");
+static_assert(type_index(TetrominoType::L) == 1, "tables below are in TetrominoType order");
+static_assert(type_index(TetrominoType::S) == 2, "tables below are in TetrominoType order");
+static_assert(type_index(TetrominoType::T) == 3, "tables below are in TetrominoType order");
+static_assert(type_index(TetrominoType::Z) == 4, "tables below are in TetrominoType order");
+static_assert(type_index(TetrominoType::I) == 5, "tables below are in TetrominoType order");
+static_assert(type_index(TetrominoType::O) == 6, "tables below are in TetrominoType order");
+
+constexpr std::array<TetrominoColor, TETROMINO_TYPES> tetromino_colors{ TetrominoColor::BLUE,   // J
+	                                                                    TetrominoColor::ORANGE, // L
+	                                                                    TetrominoColor::GREEN,  // S
+	                                                                    TetrominoColor::PURPLE, // T
+	                                                                    TetrominoColor::RED,    // Z
+	                                                                    TetrominoColor::CYAN,   // I
+	                                                                    TetrominoColor::YELLOW /* O */ };
+
+constexpr std::array<RotationStates, TETROMINO_TYPES> rotation_states{ {
+	// J
+	RotationStates{ { { { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 } } },
+	                  { { { 2, 0 }, { 1, 0 }, { 1, 1 }, { 1, 2 } } },
+	                  { { { 0, 1 }, { 1, 1 }, { 2, 1 }, { 2, 2 } } },
+	                  { { { 0, 2 }, { 1, 2 }, { 1, 1 }, { 1, 0 } } } } },
+	// L
+	RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 2, 1 }, { 2, 0 } } },
+	                  { { { 1, 0 }, { 1, 1 }, { 1, 2 }, { 2, 2 } } },
+	                  { { { 0, 2 }, { 0, 1 }, { 1, 1 }, { 2, 1 } } },
+	                  { { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 1, 2 } } } } },
+	// S
+	RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 2, 0 } } },
+	                  { { { 1, 0 }, { 1, 1 }, { 2, 1 }, { 2, 2 } } },
+	                  { { { 0, 2 }, { 1, 2 }, { 1, 1 }, { 2, 1 } } },
+	                  { { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 2 } } } } },
+	// T
+	RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 2, 1 } } },
+	                  { { { 1, 0 }, { 1, 1 }, { 2, 1 }, { 1, 2 } } },
+	                  { { { 0, 1 }, { 1, 1 }, { 1, 2 }, { 2, 1 } } },
+	                  { { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 1, 2 } } } } },
+	// Z
+	RotationStates{ { { { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 2, 1 } } },
+	                  { { { 2, 0 }, { 2, 1 }, { 1, 1 }, { 1, 2 } } },
+	                  { { { 0, 1 }, { 1, 1 }, { 1, 2 }, { 2, 2 } } },
+	                  { { { 1, 0 }, { 1, 1 }, { 0, 1 }, { 0, 2 } } } } },
+	// I
+	RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 2, 1 }, { 3, 1 } } },
+	                  { { { 2, 0 }, { 2, 1 }, { 2, 2 }, { 2, 3 } } },
+	                  { { { 0, 2 }, { 1, 2 }, { 2, 2 }, { 3, 2 } } },
+	                  { { { 1, 0 }, { 1, 1 }, { 1, 2 }, { 1, 3 } } } } },
+	// O
+	RotationStates{ { { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } },
+	                  { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } },
+	                  { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } },
+	                  { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } } } },
+} };
+
+constexpr RotationMasks make_rotation_masks(const RotationState& state)
 {
-	auto it = tetromino_color_map().find(type);
-	assert(it != tetromino_color_map().end());
-	return it->second;
+	RotationMasks masks{};
+	for (const auto& offs : state)
+	{
+		masks[offs.y] |= static_cast<uint16_t>(1u << offs.x);
+	}
+	return masks;
 }
 
-const RotationStatesMap& rotation_states_map()
+constexpr BoundingBox make_bounding_box(const RotationState& state)
 {
-	static const RotationStatesMap _ = { { TetrominoType::I,
-		                                   RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 2, 1 }, { 3, 1 } } },
-		                                                     { { { 2, 0 }, { 2, 1 }, { 2, 2 }, { 2, 3 } } },
-		                                                     { { { 0, 2 }, { 1, 2 }, { 2, 2 }, { 3, 2 } } },
-		                                                     { { { 1, 0 }, { 1, 1 }, { 1, 2 }, { 1, 3 } } } } } },
-		                                 { TetrominoType::J,
-		                                   RotationStates{ { { { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 } } },
-		                                                     { { { 2, 0 }, { 1, 0 }, { 1, 1 }, { 1, 2 } } },
-		                                                     { { { 0, 1 }, { 1, 1 }, { 2, 1 }, { 2, 2 } } },
-		                                                     { { { 0, 2 }, { 1, 2 }, { 1, 1 }, { 1, 0 } } } } } },
-		                                 { TetrominoType::L,
-		                                   RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 2, 1 }, { 2, 0 } } },
-		                                                     { { { 1, 0 }, { 1, 1 }, { 1, 2 }, { 2, 2 } } },
-		                                                     { { { 0, 2 }, { 0, 1 }, { 1, 1 }, { 2, 1 } } },
-		                                                     { { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 1, 2 } } } } } },
-		                                 { TetrominoType::O,
-		                                   RotationStates{ { { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } },
-		                                                     { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } },
-		                                                     { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } },
-		                                                     { { { 1, 0 }, { 2, 0 }, { 1, 1 }, { 2, 1 } } } } } },
-		                                 { TetrominoType::S,
-		                                   RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 2, 0 } } },
-		                                                     { { { 1, 0 }, { 1, 1 }, { 2, 1 }, { 2, 2 } } },
-		                                                     { { { 0, 2 }, { 1, 2 }, { 1, 1 }, { 2, 1 } } },
-		                                                     { { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 2 } } } } } },
-		                                 { TetrominoType::T,
-		                                   RotationStates{ { { { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 2, 1 } } },
-		                                                     { { { 1, 0 }, { 1, 1 }, { 2, 1 }, { 1, 2 } } },
-		                                                     { { { 0, 1 }, { 1, 1 }, { 1, 2 }, { 2, 1 } } },
-		                                                     { { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 1, 2 } } } } } },
-		                                 { TetrominoType::Z,
-		                                   RotationStates{ { { { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 2, 1 } } },
-		                                                     { { { 2, 0 }, { 2, 1 }, { 1, 1 }, { 1, 2 } } },
-		                                                     { { { 0, 1 }, { 1, 1 }, { 1, 2 }, { 2, 2 } } },
-		                                                     { { { 1, 0 }, { 1, 1 }, { 0, 1 }, { 0, 2 } } } } } } };
-	return _;
+	BoundingBox box{ state[0].x, state[0].x, state[0].y, state[0].y };
+	for (const auto& offs : state)
+	{
+		box.minX = offs.x < box.minX ? offs.x : box.minX;
+		box.maxX = offs.x > box.maxX ? offs.x : box.maxX;
+		box.minY = offs.y < box.minY ? offs.y : box.minY;
+		box.maxY = offs.y > box.maxY ? offs.y : box.maxY;
+	}
+	return box;
 }
 
-const RotationStates& rotation_states(TetrominoType type)
+constexpr ColumnBottoms make_column_bottoms(const RotationState& state)
+{
+	ColumnBottoms bottoms{ -1, -1, -1, -1 };
+	for (const auto& offs : state)
+	{
+		bottoms[offs.x] = offs.y > bottoms[offs.x] ? offs.y : bottoms[offs.x];
+	}
+	return bottoms;
+}
+
+struct RotationShape final
+{
+	RotationMasks masks;
+	BoundingBox   boundingBox;
+	ColumnBottoms columnBottoms;
+};
+
+using RotationShapes = std::array<std::array<RotationShape, 4>, TETROMINO_TYPES>;
+
+constexpr RotationShapes make_rotation_shapes()
 {
-	auto it = rotation_states_map().find(type);
-	assert(it != rotation_states_map().end());
-	return it->second;
+	RotationShapes shapes{};
+	for (int type = 0; type < TETROMINO_TYPES; ++type)
+	{
+		for (int rotation = 0; rotation < 4; ++rotation)
+		{
+			shapes[type][rotation].masks         = make_rotation_masks(rotation_states[type][rotation]);
+			shapes[type][rotation].boundingBox   = make_bounding_box(rotation_states[type][rotation]);
+			shapes[type][rotation].columnBottoms = make_column_bottoms(rotation_states[type][rotation]);
+		}
+	}
+	return shapes;
 }
 
+constexpr RotationShapes rotation_shapes = make_rotation_shapes();
+
+static_assert(rotation_shapes[type_index(TetrominoType::I)][0].masks[1] == 0b1111, "");
+static_assert(rotation_shapes[type_index(TetrominoType::I)][1].boundingBox.minX == 2, "");
+static_assert(rotation_shapes[type_index(TetrominoType::T)][2].boundingBox.maxY == 2, "");
+static_assert(rotation_shapes[type_index(TetrominoType::S)][3].columnBottoms[0] == 1, "");
+static_assert(rotation_shapes[type_index(TetrominoType::S)][3].columnBottoms[2] == -1, "");
+
 /*
 J, L, S, T, Z Tetromino Wall Kick Data
         Test 1   Test 2   Test 3   Test 4
@@ -97,179 +162,157 @@ L->0    (+1, 0)  (-2, 0)  (+1,-2)  (-2,+1)
 0->L    (-1, 0)  (+2, 0)  (-1,+2)  (+2,-1)
 */
 
-const WallKickMap& jlstz_wall_kick_map()
-{
-	static const WallKickMap _{ { std::make_tuple(0, RotationDirection::CLOCKWISE), // 0->R
-		                          { Offset{ -1, 0 }, Offset{ -1, +1 }, Offset{ 0, -2 }, Offset{ -1, -2 } } },
-
-		                        { std::make_tuple(1, RotationDirection::COUNTER_CLOCKWISE), // R->0
-		                          { Offset{ +1, 0 }, Offset{ +1, -1 }, Offset{ 0, +2 }, Offset{ +1, +2 } } },
+constexpr int CW  = rotation_direction_index(RotationDirection::CLOCKWISE);
+constexpr int CCW = rotation_direction_index(RotationDirection::COUNTER_CLOCKWISE);
 
-		                        { std::make_tuple(1, RotationDirection::CLOCKWISE), // R->2
-		                          { Offset{ +1, 0 }, Offset{ +1, -1 }, Offset{ 0, +2 }, Offset{ +1, +2 } } },
+constexpr int JLSTZ_KICKS = 0;
+constexpr int I_KICKS     = 1;
 
-		                        { std::make_tuple(2, RotationDirection::COUNTER_CLOCKWISE), // 2->R
-		                          { Offset{ -1, 0 }, Offset{ -1, +1 }, Offset{ 0, -2 }, Offset{ -1, -2 } } },
+constexpr WallKickMap make_wall_kick_map(const std::array<std::tuple<Rotation, int, WallKicks>, 8>& entries)
+{
+	WallKickMap map{};
+	for (const auto& entry : entries)
+	{
+		map[std::get<0>(entry)][std::get<1>(entry)] = std::get<2>(entry);
+	}
+	return map;
+}
 
-		                        { std::make_tuple(2, RotationDirection::CLOCKWISE), // 2->L
-		                          { Offset{ +1, 0 }, Offset{ +1, +1 }, Offset{ 0, -2 }, Offset{ +1, -2 } } },
+// Indexed by [kick class][rotation before rotating][direction index][test].
+constexpr std::array<WallKickMap, 2> wall_kick_maps{
+	make_wall_kick_map({ { std::make_tuple(0, CW, WallKicks{ { { -1, 0 }, { -1, +1 }, { 0, -2 }, { -1, -2 } } }),    // 0->R
+	                       std::make_tuple(1, CCW, WallKicks{ { { +1, 0 }, { +1, -1 }, { 0, +2 }, { +1, +2 } } }),   // R->0
+	                       std::make_tuple(1, CW, WallKicks{ { { +1, 0 }, { +1, -1 }, { 0, +2 }, { +1, +2 } } }),    // R->2
+	                       std::make_tuple(2, CCW, WallKicks{ { { -1, 0 }, { -1, +1 }, { 0, -2 }, { -1, -2 } } }),   // 2->R
+	                       std::make_tuple(2, CW, WallKicks{ { { +1, 0 }, { +1, +1 }, { 0, -2 }, { +1, -2 } } }),    // 2->L
+	                       std::make_tuple(3, CCW, WallKicks{ { { -1, 0 }, { -1, -1 }, { 0, +2 }, { -1, +2 } } }),   // L->2
+	                       std::make_tuple(3, CW, WallKicks{ { { -1, 0 }, { -1, -1 }, { 0, +2 }, { -1, +2 } } }),    // L->0
+	                       std::make_tuple(0, CCW, WallKicks{ { { +1, 0 }, { +1, +1 }, { 0, -2 }, { +1, -2 } } }) } }), // 0->L
+	make_wall_kick_map({ { std::make_tuple(0, CW, WallKicks{ { { -2, 0 }, { +1, 0 }, { -2, -1 }, { +1, +2 } } }),    // 0->R
+	                       std::make_tuple(1, CCW, WallKicks{ { { +2, 0 }, { -1, 0 }, { +2, +1 }, { -1, -2 } } }),   // R->0
+	                       std::make_tuple(1, CW, WallKicks{ { { -1, 0 }, { +2, 0 }, { -1, +2 }, { +2, -1 } } }),    // R->2
+	                       std::make_tuple(2, CCW, WallKicks{ { { +1, 0 }, { -2, 0 }, { +1, -2 }, { -2, +1 } } }),   // 2->R
+	                       std::make_tuple(2, CW, WallKicks{ { { +2, 0 }, { -1, 0 }, { +2, +1 }, { -1, -2 } } }),    // 2->L
+	                       std::make_tuple(3, CCW, WallKicks{ { { -2, 0 }, { +1, 0 }, { -2, -1 }, { +1, +2 } } }),   // L->2
+	                       std::make_tuple(3, CW, WallKicks{ { { +1, 0 }, { -2, 0 }, { +1, -2 }, { -2, +1 } } }),    // L->0
+	                       std::make_tuple(0, CCW, WallKicks{ { { -1, 0 }, { +2, 0 }, { -1, +2 }, { +2, -1 } } }) } }) // 0->L
+};
 
-		                        { std::make_tuple(3, RotationDirection::COUNTER_CLOCKWISE), // L->2
-		                          { Offset{ -1, 0 }, Offset{ -1, -1 }, Offset{ 0, +2 }, Offset{ -1, +2 } } },
+static_assert(wall_kick_maps[I_KICKS][2][CW][3].y == -2, "");
+static_assert(wall_kick_maps[JLSTZ_KICKS][3][CCW][1].y == -1, "");
 
-		                        { std::make_tuple(3, RotationDirection::CLOCKWISE), // L->0
-		                          { Offset{ -1, 0 }, Offset{ -1, -1 }, Offset{ 0, +2 }, Offset{ -1, +2 } } },
+} // namespace
 
-		                        { std::make_tuple(0, RotationDirection::COUNTER_CLOCKWISE), // 0->L
-		                          { Offset{ +1, 0 }, Offset{ +1, +1 }, Offset{ 0, -2 }, Offset{ +1, -2 } } } };
-	return _;
+Tetromino::Tetromino(TetrominoType type)
+    : type_{ type }
+    , rotation_{}
+{
 }
 
-const WallKickMap& i_wall_kick_map()
+Tetromino::Tetromino(TetrominoType type, Rotation rotation)
+    : type_{ type }
+    , rotation_{ rotation }
 {
-	static const WallKickMap _{ { std::make_tuple(0, RotationDirection::CLOCKWISE), // 0->R
-		                          { Offset{ -2, 0 }, Offset{ +1, 0 }, Offset{ -2, -1 }, Offset{ +1, +2 } } },
-
-		                        { std::make_tuple(1, RotationDirection::COUNTER_CLOCKWISE), // R->0
-		                          { Offset{ +2, 0 }, Offset{ -1, 0 }, Offset{ +2, +1 }, Offset{ -1, -2 } } },
-
-		                        { std::make_tuple(1, RotationDirection::CLOCKWISE), // R->2
-		                          { Offset{ -1, 0 }, Offset{ +2, 0 }, Offset{ -1, +2 }, Offset{ +2, -1 } } },
-
-		                        { std::make_tuple(2, RotationDirection::COUNTER_CLOCKWISE), // 2->R
-		                          { Offset{ +1, 0 }, Offset{ -2, 0 }, Offset{ +1, -2 }, Offset{ -2, +1 } } },
-
-		                        { std::make_tuple(2, RotationDirection::CLOCKWISE), // 2->L
-		                          { Offset{ +2, 0 }, Offset{ -1, 0 }, Offset{ +2, +1 }, Offset{ -1, -2 } } },
-
-		                        { std::make_tuple(3, RotationDirection::COUNTER_CLOCKWISE), // L->2
-		                          { Offset{ -2, 0 }, Offset{ +1, 0 }, Offset{ -2, -1 }, Offset{ +1, +2 } } },
-
-		                        { std::make_tuple(3, RotationDirection::CLOCKWISE), // L->0
-		                          { Offset{ +1, 0 }, Offset{ -2, 0 }, Offset{ +1, -2 }, Offset{ -2, +1 } } },
-
-		                        { std::make_tuple(0, RotationDirection::COUNTER_CLOCKWISE), // 0->L
-		                          { Offset{ -1, 0 }, Offset{ +2, 0 }, Offset{ -1, +2 }, Offset{ +2, -1 } } } };
-	return _;
+	assert(rotation >= 0 && rotation < 4);
 }
 
-std::optional<std::reference_wrapper<const WallKickMap>> wall_kick_map(TetrominoType type)
+TetrominoType Tetromino::type() const
 {
-	switch (type)
-	{
-	case TetrominoType::O:
-		return std::nullopt;
-	case TetrominoType::I:
-		return i_wall_kick_map();
-	case TetrominoType::J:
-	case TetrominoType::L:
-	case TetrominoType::S:
-	case TetrominoType::T:
-	case TetrominoType::Z:
-		return jlstz_wall_kick_map();
-	}
-	throw std::runtime_error{ "should not happen" };
+	return this->type_;
 }
 
-} // namespace
-
-class Tetromino::impl final
+TetrominoColor Tetromino::color() const
 {
-	TetrominoType                                            type_;
-	TetrominoColor                                           color_;
-	const RotationStates&                                    rotationStates_;
-	Rotation                                                 rotation_;
-	std::optional<std::reference_wrapper<const WallKickMap>> wallKickMap_;
-
-public:
-	explicit impl(TetrominoType type)
-	    : type_{ type }
-	    , color_{ tetromino_color(type) }
-	    , rotationStates_{ rotation_states(type) }
-	    , rotation_{}
-	    , wallKickMap_{ wall_kick_map(type) }
-	{
-	}
-
-	TetrominoType type() const
-	{
-		return this->type_;
-	}
-
-	TetrominoColor color() const
-	{
-		return this->color_;
-	}
+	return Tetromino::color(this->type_);
+}
 
-	Rotation rotation() const
-	{
-		return this->rotation_;
-	}
+Rotation Tetromino::rotation() const
+{
+	return this->rotation_;
+}
 
-	const RotationState& rotationState() const
-	{
-		assert(this->rotation_ >= 0 && this->rotation_ < static_cast<int>(this->rotationStates_.size()));
-		return this->rotationStates_[this->rotation_];
-	}
+const RotationState& Tetromino::rotationState() const
+{
+	return Tetromino::rotationState(this->type_, this->rotation_);
+}
 
-	void rotate(RotationDirection direction)
-	{
-		static_assert(static_cast<int>(RotationDirection::CLOCKWISE) == 1, "");
-		static_assert(static_cast<int>(RotationDirection::COUNTER_CLOCKWISE) == -1, "");
-		this->rotation_ = (this->rotation_ + this->rotationStates_.size() + static_cast<int>(direction)) % this->rotationStates_.size();
-	}
+const RotationMasks& Tetromino::rotationMasks() const
+{
+	return Tetromino::rotationMasks(this->type_, this->rotation_);
+}
 
-	void rotateOpposite(RotationDirection direction)
-	{
-		this->rotate(static_cast<RotationDirection>(-static_cast<int>(direction)));
-	}
+const BoundingBox& Tetromino::boundingBox() const
+{
+	return Tetromino::boundingBox(this->type_, this->rotation_);
+}
 
-	std::optional<std::reference_wrapper<const WallKickMap>> wallKickMap() const
-	{
-		return this->wallKickMap_;
-	}
-};
+const ColumnBottoms& Tetromino::columnBottoms() const
+{
+	return Tetromino::columnBottoms(this->type_, this->rotation_);
+}
 
-Tetromino::Tetromino(TetrominoType type)
-    : pimpl_{ std::make_unique<impl>(type) }
+void Tetromino::rotate(RotationDirection direction)
 {
+	static_assert(static_cast<int>(RotationDirection::CLOCKWISE) == 1, "");
+	static_assert(static_cast<int>(RotationDirection::COUNTER_CLOCKWISE) == -1, "");
+	constexpr auto rotations = static_cast<int>(std::tuple_size<RotationStates>::value);
+	this->rotation_          = (this->rotation_ + rotations + static_cast<int>(direction)) % rotations;
 }
 
-Tetromino::~Tetromino() noexcept
+void Tetromino::rotateOpposite(RotationDirection direction)
 {
+	this->rotate(static_cast<RotationDirection>(-static_cast<int>(direction)));
 }
 
-TetrominoType Tetromino::type() const
+const WallKickMap* Tetromino::wallKickMap() const
 {
-	return this->pimpl_->type();
+	return Tetromino::wallKickMap(this->type_);
 }
 
-TetrominoColor Tetromino::color() const
+TetrominoColor Tetromino::color(TetrominoType type)
 {
-	return this->pimpl_->color();
+	assert(type_index(type) >= 0 && type_index(type) < TETROMINO_TYPES);
+	return tetromino_colors[type_index(type)];
 }
 
-Rotation Tetromino::rotation() const
+const RotationState& Tetromino::rotationState(TetrominoType type, Rotation rotation)
 {
-	return this->pimpl_->rotation();
+	assert(type_index(type) >= 0 && type_index(type) < TETROMINO_TYPES && rotation >= 0 && rotation < 4);
+	return rotation_states[type_index(type)][rotation];
 }
 
-const RotationState& Tetromino::rotationState() const
+const RotationMasks& Tetromino::rotationMasks(TetrominoType type, Rotation rotation)
 {
-	return this->pimpl_->rotationState();
+	assert(type_index(type) >= 0 && type_index(type) < TETROMINO_TYPES && rotation >= 0 && rotation < 4);
+	return rotation_shapes[type_index(type)][rotation].masks;
 }
 
-void Tetromino::rotate(RotationDirection direction)
+const BoundingBox& Tetromino::boundingBox(TetrominoType type, Rotation rotation)
 {
-	return this->pimpl_->rotate(direction);
+	assert(type_index(type) >= 0 && type_index(type) < TETROMINO_TYPES && rotation >= 0 && rotation < 4);
+	return rotation_shapes[type_index(type)][rotation].boundingBox;
 }
 
-void Tetromino::rotateOpposite(RotationDirection direction)
+const ColumnBottoms& Tetromino::columnBottoms(TetrominoType type, Rotation rotation)
 {
-	return this->pimpl_->rotateOpposite(direction);
+	assert(type_index(type) >= 0 && type_index(type) < TETROMINO_TYPES && rotation >= 0 && rotation < 4);
+	return rotation_shapes[type_index(type)][rotation].columnBottoms;
 }
 
-std::optional<std::reference_wrapper<const WallKickMap>> Tetromino::wallKickMap() const
+const WallKickMap* Tetromino::wallKickMap(TetrominoType type)
 {
-	return this->pimpl_->wallKickMap();
+	switch (type)
+	{
+	case TetrominoType::O:
+		return nullptr;
+	case TetrominoType::I:
+		return &wall_kick_maps[I_KICKS];
+	case TetrominoType::J:
+	case TetrominoType::L:
+	case TetrominoType::S:
+	case TetrominoType::T:
+	case TetrominoType::Z:
+		return &wall_kick_maps[JLSTZ_KICKS];
+	}
+	throw std::runtime_error{ "should not happen" };
 }
@@ -3,40 +3,60 @@
 #include "offset.h"
 #include "tetrominotype.h"
 
-#include <memory>
-#include <optional>
-#include <tuple>
-#include <map>
-#include <functional>
+#include <array>
+#include <cstdint>
 
 enum class TetrominoColor;
 enum class RotationDirection;
 
-using Rotation          = int;
-using RotationState     = std::array<Offset, 4>;
-using RotationStates    = std::array<RotationState, 4>;
-using RotationStatesMap = std::map<TetrominoType, RotationStates>;
+using Rotation       = int;
+using RotationState  = std::array<Offset, 4>;
+using RotationStates = std::array<RotationState, 4>;
 
-using WallKickKey = std::tuple<Rotation, RotationDirection>;
-using WallKicks   = std::array<Offset, 4>;
-using WallKickMap = std::map<WallKickKey, WallKicks>;
+// Occupancy of the 4 rows spanned by a rotation state. Bit N of entry Y is set for Offset{ N, Y }.
+using RotationMasks = std::array<uint16_t, 4>;
 
+struct BoundingBox final
+{
+	int minX, maxX, minY, maxY;
+};
+
+// The largest Offset::y in each of the 4 columns spanned by a rotation state, or -1 for a column it does not occupy.
+using ColumnBottoms = std::array<int, 4>;
+
+using WallKicks = std::array<Offset, 4>;
+
+// Wall kick tests of one kick class, indexed by the rotation before rotating and by rotation_direction_index().
+using WallKickMap = std::array<std::array<WallKicks, 2>, 4>;
+
+// A value type: the shape data lives in static tables, so copying a tetromino is copying two integers.
 class Tetromino final
 {
-	class impl;
-	std::unique_ptr<impl> pimpl_;
+	TetrominoType type_;
+	Rotation      rotation_;
 
 public:
 	explicit Tetromino(TetrominoType type);
-	~Tetromino() noexcept;
+	explicit Tetromino(TetrominoType type, Rotation rotation);
 
 	TetrominoType        type() const;
 	TetrominoColor       color() const;
 	Rotation             rotation() const;
 	const RotationState& rotationState() const;
+	const RotationMasks& rotationMasks() const;
+	const BoundingBox&   boundingBox() const;
+	const ColumnBottoms& columnBottoms() const;
 
 	void rotate(RotationDirection direction);
 	void rotateOpposite(RotationDirection direction);
 
-	std::optional<std::reference_wrapper<const WallKickMap>> wallKickMap() const;
+	// Returns nullptr for tetrominoes that do not kick.
+	const WallKickMap* wallKickMap() const;
+
+	static TetrominoColor       color(TetrominoType type);
+	static const RotationState& rotationState(TetrominoType type, Rotation rotation);
+	static const RotationMasks& rotationMasks(TetrominoType type, Rotation rotation);
+	static const BoundingBox&   boundingBox(TetrominoType type, Rotation rotation);
+	static const ColumnBottoms& columnBottoms(TetrominoType type, Rotation rotation);
+	static const WallKickMap*   wallKickMap(TetrominoType type);
 };
@@ -8,5 +8,6 @@ enum class TetrominoColor
 	GREEN,
 	ORANGE,
 	BLUE,
-	CYAN
+	CYAN,
+	GREY // garbage
 };
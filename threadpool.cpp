@@ -0,0 +1,255 @@
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+class ThreadPool::impl final
+{
+	using Task = std::function<void()>;
+
+	struct Queue final
+	{
+		std::mutex       mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues_{};
+	std::vector<std::thread>            threads_{};
+	std::mutex                          mutex_{};
+	std::condition_variable             wakeUp_{};
+	std::atomic<size_t>                 queued_{};
+	std::atomic<unsigned>               nextQueue_{};
+	bool                                stopping_{};
+
+	// The pool and queue index of the worker running on this thread, if any.
+	static thread_local impl*    currentPool_;
+	static thread_local unsigned currentQueue_;
+
+	std::optional<Task> popFrom(unsigned index, bool newest)
+	{
+		auto&                       queue = *this->queues_[index];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (queue.tasks.empty())
+		{
+			return std::nullopt;
+		}
+		std::optional<Task> task{};
+		if (newest)
+		{
+			task.emplace(std::move(queue.tasks.back()));
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task.emplace(std::move(queue.tasks.front()));
+			queue.tasks.pop_front();
+		}
+		--this->queued_;
+		return task;
+	}
+
+	std::optional<Task> pop(unsigned index)
+	{
+		if (auto task = this->popFrom(index, true))
+		{
+			return task;
+		}
+		const auto count = static_cast<unsigned>(this->queues_.size());
+		for (unsigned i = 1; i < count; ++i)
+		{
+			if (auto task = this->popFrom((index + i) % count, false))
+			{
+				return task;
+			}
+		}
+		return std::nullopt;
+	}
+
+	void work(unsigned index)
+	{
+		currentPool_  = this;
+		currentQueue_ = index;
+		for (;;)
+		{
+			if (auto task = this->pop(index))
+			{
+				(*task)();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock{ this->mutex_ };
+			this->wakeUp_.wait(lock, [this]() { return this->stopping_ || this->queued_ > 0; });
+			if (this->stopping_ && this->queued_ == 0)
+			{
+				return;
+			}
+		}
+	}
+
+	// Runs one queued task on the calling thread, if there is one.
+	bool runOne()
+	{
+		const auto index = currentPool_ == this ? currentQueue_ : this->nextQueue_.load() % this->queues_.size();
+		if (auto task = this->pop(static_cast<unsigned>(index)))
+		{
+			(*task)();
+			return true;
+		}
+		return false;
+	}
+
+public:
+	explicit impl(unsigned threads)
+	{
+		if (threads == 0)
+		{
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		for (unsigned i = 0; i < threads; ++i)
+		{
+			this->queues_.push_back(std::make_unique<Queue>());
+		}
+		for (unsigned i = 0; i < threads; ++i)
+		{
+			this->threads_.emplace_back([this, i]() { this->work(i); });
+		}
+	}
+
+	~impl() noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock{ this->mutex_ };
+			this->stopping_ = true;
+		}
+		this->wakeUp_.notify_all();
+		for (auto& thread : this->threads_)
+		{
+			thread.join();
+		}
+	}
+
+	unsigned size() const
+	{
+		return static_cast<unsigned>(this->threads_.size());
+	}
+
+	void submit(Task task)
+	{
+		// Workers push onto their own queue, which keeps nested work local; other threads deal round robin.
+		const auto index = currentPool_ == this ? currentQueue_ : this->nextQueue_++ % this->queues_.size();
+		{
+			auto&                       queue = *this->queues_[index];
+			std::lock_guard<std::mutex> lock{ queue.mutex };
+			queue.tasks.push_back(std::move(task));
+			++this->queued_;
+		}
+		{
+			std::lock_guard<std::mutex> lock{ this->mutex_ };
+		}
+		this->wakeUp_.notify_one();
+	}
+
+	void parallelFor(size_t count, const std::function<void(size_t)>& body)
+	{
+		struct Shared final
+		{
+			std::atomic<size_t>     next{};
+			std::atomic<size_t>     pending{};
+			std::mutex              mutex{};
+			std::condition_variable done{};
+			std::exception_ptr      exception{};
+		};
+
+		Shared     shared{};
+		const auto run = [&shared, &body, count]() {
+			for (;;)
+			{
+				const auto i = shared.next++;
+				if (i >= count)
+				{
+					break;
+				}
+				try
+				{
+					body(i);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock{ shared.mutex };
+					if (!shared.exception)
+					{
+						shared.exception = std::current_exception();
+					}
+				}
+			}
+		};
+
+		// Every helper claims indices from the shared counter until none are left, so the load balances itself.
+		const auto helpers = std::min<size_t>(count, this->size()) - (count > 0 ? 1 : 0);
+		shared.pending     = helpers;
+		for (size_t i = 0; i < helpers; ++i)
+		{
+			this->submit([&shared, &run]() {
+				run();
+				std::lock_guard<std::mutex> lock{ shared.mutex };
+				if (--shared.pending == 0)
+				{
+					shared.done.notify_all();
+				}
+			});
+		}
+
+		run();
+
+		while (shared.pending > 0)
+		{
+			if (!this->runOne())
+			{
+				std::unique_lock<std::mutex> lock{ shared.mutex };
+				shared.done.wait_for(lock, std::chrono::milliseconds{ 1 }, [&shared]() { return shared.pending == 0; });
+			}
+		}
+
+		// The last helper may still be releasing the mutex after its notify; wait for that before 'shared' goes away.
+		std::lock_guard<std::mutex> lock{ shared.mutex };
+		if (shared.exception)
+		{
+			std::rethrow_exception(shared.exception);
+		}
+	}
+};
+
+thread_local ThreadPool::impl* ThreadPool::impl::currentPool_{};
+thread_local unsigned          ThreadPool::impl::currentQueue_{};
+
+ThreadPool::ThreadPool(unsigned threads)
+    : pimpl_{ std::make_unique<impl>(threads) }
+{
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+}
+
+unsigned ThreadPool::size() const
+{
+	return this->pimpl_->size();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+	return this->pimpl_->submit(std::move(task));
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+	return this->pimpl_->parallelFor(count, body);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+// A fixed set of worker threads with one task deque each. A worker takes its newest own task first and, when it runs dry,
+// steals the oldest task of another worker, so independent work spreads over all cores without a shared queue.
+class ThreadPool final
+{
+	class impl;
+	std::unique_ptr<impl> pimpl_;
+
+public:
+	// Zero threads means one per hardware thread.
+	explicit ThreadPool(unsigned threads = 0);
+	~ThreadPool() noexcept;
+
+	unsigned size() const;
+
+	void submit(std::function<void()> task);
+
+	// Calls body(i) for every i in [0, count), spread over the workers, and returns once all calls are done. The calling
+	// thread takes part, so this may be nested inside a task. The first exception thrown by body is rethrown here.
+	void parallelFor(size_t count, const std::function<void(size_t)>& body);
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+enum class InputEvent;
+
+struct TimedInput final
+{
+	uint64_t   frame;
+	InputEvent event;
+};
@@ -0,0 +1,347 @@
+#include "tournament.h"
+#include "board.h"
+#include "iplayer.h"
+#include "threadpool.h"
+#include "xoshiro256.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+// points[game][i][j]: what entrant i took from entrant j in the game, 1 for a win and a half for a draw. Side by side a
+// game is a seed; in versus there are two per seed, one for each seating of a pair.
+using Points = std::vector<std::vector<std::vector<double>>>;
+
+// Points and matches of each pair of entrants, in the given games.
+struct Results final
+{
+	std::vector<std::vector<double>> points, matches;
+
+	explicit Results(size_t entrants)
+	    : points(entrants, std::vector<double>(entrants))
+	    , matches(entrants, std::vector<double>(entrants))
+	{
+	}
+
+	void add(const Points& games, size_t game)
+	{
+		const auto& result = games[game];
+		for (size_t i = 0; i < result.size(); ++i)
+		{
+			for (size_t j = i + 1; j < result.size(); ++j)
+			{
+				const auto p = result[i][j];
+				this->points[i][j] += p;
+				this->points[j][i] += 1 - p;
+				this->matches[i][j] += 1;
+				this->matches[j][i] += 1;
+			}
+		}
+	}
+};
+
+// Game g of every entrant is played with the same seed, and an entrant beats another on it by clearing more lines.
+void play_side_by_side(ThreadPool&                       pool,
+                       const Tournament::Options&        options,
+                       const std::vector<Entrant>&       entrants,
+                       Points&                           points,
+                       std::vector<std::vector<double>>& lines)
+{
+	const auto n     = entrants.size();
+	const auto games = options.games;
+
+	lines.assign(n, std::vector<double>(games));
+	pool.parallelFor(n * games, [&](size_t job) {
+		const auto entrant = job / games;
+		const auto seed    = BatchRunner::gameSeed(options.seed, job % games);
+		const auto player  = entrants[entrant].playerFactory(seed);
+
+		lines[entrant][job % games] = BatchRunner::play(*player, seed, options.maxPieces).lines;
+	});
+
+	points.assign(games, std::vector<std::vector<double>>(n, std::vector<double>(n)));
+	for (size_t game = 0; game < games; ++game)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < n; ++j)
+			{
+				const auto a = lines[i][game], b = lines[j][game];
+				points[game][i][j] = a > b ? 1.0 : a < b ? 0.0 : 0.5;
+			}
+		}
+	}
+}
+
+// Every pair of entrants plays a Versus match per seed in both seatings, as the boards take turns within a frame, won by
+// the one left standing and drawn when both still play at maxFrames. Both seatings deal the same tetrominoes, and a seat
+// keeps its garbage holes and its controller seed whoever sits in it.
+void play_versus(ThreadPool&                       pool,
+                 const Tournament::Options&        options,
+                 const std::vector<Entrant>&       entrants,
+                 Points&                           points,
+                 std::vector<std::vector<double>>& lines)
+{
+	const auto n     = entrants.size();
+	const auto games = options.games;
+
+	std::vector<std::pair<size_t, size_t>> pairs{};
+	for (size_t i = 0; i < n; ++i)
+	{
+		for (size_t j = i + 1; j < n; ++j)
+		{
+			pairs.emplace_back(i, j);
+		}
+	}
+
+	// For each match, the winning seat, if any, and the lines of both seats.
+	std::vector<std::optional<size_t>>   winners(2 * games * pairs.size());
+	std::vector<std::array<uint32_t, 2>> matchLines(winners.size());
+	pool.parallelFor(winners.size(), [&](size_t job) {
+		const auto seating = job % 2;
+		const auto pair    = pairs[job / 2 % pairs.size()];
+		const auto seed    = BatchRunner::gameSeed(options.seed, job / 2 / pairs.size());
+		const auto seats   = seating ? std::array<size_t, 2>{ pair.second, pair.first } : std::array<size_t, 2>{ pair.first, pair.second };
+
+		Versus versus{ 2, options.versus };
+		versus.play(seed,
+		            { entrants[seats[0]].controllerFactory(seed), entrants[seats[1]].controllerFactory(seed + 1) },
+		            options.maxFrames);
+		winners[job]    = versus.winner();
+		matchLines[job] = { versus.board(0).lines(), versus.board(1).lines() };
+	});
+
+	points.assign(2 * games, std::vector<std::vector<double>>(n, std::vector<double>(n)));
+	lines.assign(n, {});
+	for (size_t job = 0; job < winners.size(); ++job)
+	{
+		const auto seating = job % 2;
+		const auto pair    = pairs[job / 2 % pairs.size()];
+		const auto seats   = seating ? std::array<size_t, 2>{ pair.second, pair.first } : std::array<size_t, 2>{ pair.first, pair.second };
+		const auto game    = 2 * (job / 2 / pairs.size()) + seating;
+		for (size_t seat = 0; seat < 2; ++seat)
+		{
+			const auto entrant = seats[seat], opponent = seats[1 - seat];
+			points[game][entrant][opponent] = !winners[job] ? 0.5 : *winners[job] == seat ? 1.0 : 0.0;
+			lines[entrant].push_back(matchLines[job][seat]);
+		}
+	}
+}
+
+// The Bradley-Terry strengths that make the results most likely, by the minorization-maximization iteration of Hunter
+// ("MM algorithms for generalized Bradley-Terry models", 2004), as Elo ratings averaging zero. One virtual draw between
+// every pair keeps the ratings finite when an entrant wins or loses all its matches.
+std::vector<double> fit(const Results& results)
+{
+	const auto          n = results.points.size();
+	std::vector<double> strength(n, 1.0), next(n);
+	for (int iteration = 0; iteration < 10000; ++iteration)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			double points{}, weight{};
+			for (size_t j = 0; j < n; ++j)
+			{
+				if (j != i)
+				{
+					points += results.points[i][j] + 0.5;
+					weight += (results.matches[i][j] + 1) / (strength[i] + strength[j]);
+				}
+			}
+			next[i] = points / weight;
+		}
+
+		auto logMean = 0.0;
+		for (const auto s : next)
+		{
+			logMean += std::log(s);
+		}
+		const auto scale = std::exp(-logMean / static_cast<double>(n));
+
+		auto change = 0.0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			next[i] *= scale;
+			change = std::max(change, std::abs(next[i] / strength[i] - 1));
+		}
+		strength.swap(next);
+		if (change < 1e-10)
+		{
+			break;
+		}
+	}
+
+	std::vector<double> elo(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		elo[i] = 400 * std::log10(strength[i]);
+	}
+	return elo;
+}
+
+} // namespace
+
+std::string TournamentReport::summary() const
+{
+	auto result = fmt::format("{} entrants, {} games on {} threads in {:.3f} s, {:.1f} games/s\n",
+	                          this->ratings.size(),
+	                          this->games,
+	                          this->threads,
+	                          this->seconds,
+	                          this->gamesPerSecond);
+
+	result += fmt::format("{:>4}  {:>6}  {:>14}  {:>6} {:>6} {:>6}  {:>8}  {}\n",
+	                      "rank",
+	                      "elo",
+	                      "95% interval",
+	                      "won",
+	                      "drawn",
+	                      "lost",
+	                      "lines",
+	                      "player");
+	for (size_t rank = 0; rank < this->ratings.size(); ++rank)
+	{
+		const auto& r = this->ratings[rank];
+		result += fmt::format("{:>4}  {:>+6.0f}  [{:>+5.0f}, {:>+5.0f}]  {:>6} {:>6} {:>6}  {:>8.1f}  {}\n",
+		                      rank + 1,
+		                      r.elo,
+		                      r.low,
+		                      r.high,
+		                      r.wins,
+		                      r.draws,
+		                      r.losses,
+		                      r.lines.mean,
+		                      r.name);
+	}
+
+	// The share of the points each entrant took from each other one, in the order of the ranking.
+	result += fmt::format("\n{:>4} ", "");
+	for (size_t j = 0; j < this->scores.size(); ++j)
+	{
+		result += fmt::format(" {:>5}", j + 1);
+	}
+	result += '\n';
+	for (size_t i = 0; i < this->scores.size(); ++i)
+	{
+		result += fmt::format("{:>4} ", i + 1);
+		for (size_t j = 0; j < this->scores.size(); ++j)
+		{
+			result += i == j ? fmt::format(" {:>5}", "-") : fmt::format(" {:>4.0f}%", 100 * this->scores[i][j]);
+		}
+		result += '\n';
+	}
+	return result;
+}
+
+TournamentReport Tournament::run(ThreadPool& pool, const Options& options, const std::vector<Entrant>& entrants)
+{
+	if (entrants.size() < 2)
+	{
+		throw std::invalid_argument{ "a tournament needs at least two players" };
+	}
+
+	const auto n      = entrants.size();
+	const auto versus = options.mode == Mode::VERSUS;
+	const auto seeds  = options.games;
+	const auto sides  = versus ? size_t{ 2 } : size_t{ 1 }; // games per seed
+	if (versus && std::any_of(entrants.begin(), entrants.end(), [](const Entrant& entrant) { return !entrant.controllerFactory; }))
+	{
+		throw std::invalid_argument{ "every player of a versus tournament needs to play in real time" };
+	}
+
+	TournamentReport report{};
+	report.games   = versus ? seeds * n * (n - 1) : n * seeds;
+	report.threads = pool.size();
+
+	Points                           points{};
+	std::vector<std::vector<double>> lines{};
+	const auto                       started = std::chrono::steady_clock::now();
+	if (versus)
+	{
+		play_versus(pool, options, entrants, points, lines);
+	}
+	else
+	{
+		play_side_by_side(pool, options, entrants, points, lines);
+	}
+	report.seconds        = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+	report.gamesPerSecond = report.seconds > 0 ? report.games / report.seconds : 0;
+
+	Results results{ n };
+	for (size_t game = 0; game < points.size(); ++game)
+	{
+		results.add(points, game);
+	}
+	const auto elo = fit(results);
+
+	// Resampling whole seeds keeps the pairing of the games, which is what makes the ratings precise.
+	std::vector<std::vector<double>> resampled(options.bootstraps);
+	pool.parallelFor(options.bootstraps, [&](size_t bootstrap) {
+		Xoshiro256 random{ BatchRunner::gameSeed(options.seed, bootstrap) };
+		Results    sample{ n };
+		for (size_t i = 0; i < seeds; ++i)
+		{
+			const auto seed = random.below(static_cast<uint32_t>(seeds));
+			for (size_t side = 0; side < sides; ++side)
+			{
+				sample.add(points, sides * seed + side);
+			}
+		}
+		resampled[bootstrap] = fit(sample);
+	});
+
+	std::vector<Rating> ratings(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		auto& rating = ratings[i];
+		rating.name  = entrants[i].name;
+		rating.elo   = elo[i];
+
+		std::vector<double> samples{};
+		for (const auto& sample : resampled)
+		{
+			samples.push_back(sample[i]);
+		}
+		std::sort(samples.begin(), samples.end());
+		rating.low  = samples.empty() ? elo[i] : Distribution::percentile(samples, 0.025);
+		rating.high = samples.empty() ? elo[i] : Distribution::percentile(samples, 0.975);
+
+		for (const auto& game : points)
+		{
+			for (size_t j = 0; j < n; ++j)
+			{
+				if (j != i)
+				{
+					rating.wins += game[i][j] == 1;
+					rating.draws += game[i][j] == 0.5;
+					rating.losses += game[i][j] == 0;
+				}
+			}
+		}
+		rating.lines = Distribution::of(lines[i]);
+	}
+
+	std::vector<size_t> order(n);
+	std::iota(order.begin(), order.end(), size_t{});
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return elo[a] > elo[b]; });
+
+	report.scores.assign(n, std::vector<double>(n));
+	for (size_t i = 0; i < n; ++i)
+	{
+		report.ratings.push_back(ratings[order[i]]);
+		for (size_t j = 0; j < n; ++j)
+		{
+			const auto matches  = results.matches[order[i]][order[j]];
+			report.scores[i][j] = matches > 0 ? results.points[order[i]][order[j]] / matches : 0;
+		}
+	}
+	return report;
+}
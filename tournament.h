@@ -0,0 +1,74 @@
+#pragma once
+
+#include "batchrunner.h"
+#include "versus.h"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+struct Entrant final
+{
+	std::string                name;
+	BatchRunner::PlayerFactory playerFactory;
+	Versus::ControllerFactory  controllerFactory{}; // for versus, by players that can play in real time
+};
+
+struct Rating final
+{
+	std::string  name;
+	double       elo;       // relative to the average of the field
+	double       low, high; // 95% confidence interval
+	uint64_t     wins, draws, losses;
+	Distribution lines;
+};
+
+struct TournamentReport final
+{
+	std::vector<Rating>              ratings; // best first
+	std::vector<std::vector<double>> scores;  // scores[i][j]: the share of the points entrant i took from entrant j
+	size_t                           games;
+	unsigned                         threads;
+	double                           seconds;
+	double                           gamesPerSecond;
+
+	std::string summary() const;
+};
+
+// Rates players against each other. Every entrant plays the same seeds, so for each seed all of them get the same
+// tetrominoes, and each pair of entrants has a match per seed, won by the one that cleared more lines. As the luck of the
+// draw is the same on both sides, a match only measures the players, and far fewer games tell them apart than with
+// independent seeds.
+//
+// The ratings are the Elo ratings that best explain all the match results at once (the Bradley-Terry maximum likelihood
+// estimate), which unlike updating ratings game by game does not depend on the order of the games. Their confidence
+// intervals come from bootstrapping: the ratings are estimated again from seeds drawn with replacement.
+//
+// In versus mode the entrants play each other directly instead: each pair has a Versus match per seed in either seating,
+// won by the board left standing, so that garbage and speed count as well as lines.
+class Tournament final
+{
+public:
+	enum class Mode
+	{
+		SIDE_BY_SIDE, // every entrant plays each seed alone, and the one clearing more lines wins
+		VERSUS        // every pair plays each seed against each other, twice
+	};
+
+	struct Options final
+	{
+		size_t   games      = 100; // seeds, each played by every entrant
+		uint64_t seed       = 1;
+		uint32_t maxPieces  = 1000; // stop a game after this many tetrominoes, 0 for no limit
+		size_t   bootstraps = 200;
+
+		Mode            mode = Mode::SIDE_BY_SIDE;
+		Versus::Options versus{};
+		uint64_t        maxFrames = 10 * 60 * Simulation::FRAMES_PER_SECOND; // a versus match still going by then is drawn
+	};
+
+	static TournamentReport run(ThreadPool& pool, const Options& options, const std::vector<Entrant>& entrants);
+};
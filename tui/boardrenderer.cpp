@@ -48,19 +48,31 @@ Size BoardRenderer::size()
 }
 
 void BoardRenderer::render(const Board& board, AsioTerminal& terminal)
+{
+	render(std::vector<const Board*>{ &board }, terminal);
+}
+
+void BoardRenderer::render(const std::vector<const Board*>& boards, AsioTerminal& terminal)
 {
 	terminal.cls(Attribute::BG_BLACK);
 	const auto terminalSize = terminal.size();
 
 	auto& minoRenderer = MinoRenderer::instance();
 
-	Size               boardSize{};
+	// All the boards, with a mino between each two.
+	const auto count     = static_cast<int>(boards.size());
+	const auto totalSize = [count]() {
+		const auto boardSize = BoardRenderer::size();
+		return Size{ boardSize.rows, count * boardSize.colums + (count - 1) * MinoRenderer::instance().size().colums };
+	};
+
+	Size               boardsSize{};
 	std::optional<int> minoHeight{};
 	for (int height = 1;; ++height)
 	{
 		minoRenderer.setSize(Size{ height, height * 2 });
-		boardSize = BoardRenderer::size();
-		if (boardSize <= terminalSize)
+		boardsSize = totalSize();
+		if (boardsSize <= terminalSize)
 		{
 			minoHeight = height;
 		}
@@ -73,16 +85,29 @@ void BoardRenderer::render(const Board& board, AsioTerminal& terminal)
 	if (minoHeight)
 	{
 		minoRenderer.setSize(Size{ minoHeight.value(), minoHeight.value() * 2 });
-		boardSize = BoardRenderer::size();
+		boardsSize = totalSize();
 	}
 	else
 	{
 		throw std::runtime_error{ fmt::format(
-			"Terminal too small. Need at least {} rows and {} columns.", boardSize.rows, boardSize.colums) };
+			"Terminal too small. Need at least {} rows and {} columns.", boardsSize.rows, boardsSize.colums) };
 	}
 
-	Position boardOrigin{ (terminalSize.colums - boardSize.colums) / 2, (terminalSize.rows - boardSize.rows) / 2 };
-	auto     origin = boardOrigin;
+	const auto boardStep = Position{ BoardRenderer::size().colums + minoRenderer.size().colums, 0 };
+	auto       origin    = Position{ (terminalSize.colums - boardsSize.colums) / 2, (terminalSize.rows - boardsSize.rows) / 2 };
+	for (const auto board : boards)
+	{
+		draw(*board, terminal, origin);
+		origin += boardStep;
+	}
+
+	terminal.update();
+}
+
+void BoardRenderer::draw(const Board& board, AsioTerminal& terminal, const Position& boardOrigin)
+{
+	auto& minoRenderer = MinoRenderer::instance();
+	auto  origin       = boardOrigin;
 
 	const auto  borderAttr = Attribute::FG_LIGHTGRAY;
 	const auto& minoSize   = minoRenderer.size();
@@ -113,7 +138,7 @@ void BoardRenderer::render(const Board& board, AsioTerminal& terminal)
 	{
 		for (int column = 0; column < Grid::width(); ++column)
 		{
-			const auto& cell = board.grid().cell(row, column);
+			const auto cell = board.cell(row, column);
 			if (cell.has_value())
 			{
 				minoRenderer.render(terminal, Position{ column * minoSize.colums, row * minoSize.rows } + origin, cell.value());
@@ -188,8 +213,6 @@ void BoardRenderer::render(const Board& board, AsioTerminal& terminal)
 		origin += Position{ 0, 2 * minoSize.rows };
 		terminal.print(gameOverColor, origin, "O V E R");
 	}
-
-	terminal.update();
 }
 
 } // namespace tui
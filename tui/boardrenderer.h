@@ -1,20 +1,27 @@
 #pragma once
 
+#include <vector>
+
 class Board;
 
 namespace tui {
 
 class Size;
 class AsioTerminal;
+struct Position;
 
 class BoardRenderer final
 {
 	static constexpr int PREVIEW_WIDTH  = 6;
 	static constexpr int PREVIEW_HEIGHT = 4;
 
+	static void draw(const Board& board, AsioTerminal& terminal, const Position& boardOrigin);
+
 public:
 	static Size size();
 	static void render(const Board& board, AsioTerminal& terminal);
+	// Side by side, a mino apart, as large as the terminal fits them all.
+	static void render(const std::vector<const Board*>& boards, AsioTerminal& terminal);
 };
 
 } // namespace tui
@@ -21,7 +21,8 @@ const MinoColorsMapType& mino_color_map()
 		                              { TetrominoColor::GREEN, Attribute::FG_LIGHTGREEN },
 		                              { TetrominoColor::ORANGE, Attribute::FG_BROWN },
 		                              { TetrominoColor::BLUE, Attribute::FG_LIGHTBLUE },
-		                              { TetrominoColor::CYAN, Attribute::FG_CYAN } };
+		                              { TetrominoColor::CYAN, Attribute::FG_CYAN },
+		                              { TetrominoColor::GREY, Attribute::FG_DARKGRAY } };
 	return _;
 }
 
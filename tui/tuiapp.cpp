@@ -6,20 +6,68 @@
 #include "boardrenderer.h"
 #include "inputevent.h"
 #include "timer.h"
+#include "replay.h"
+#include "replayplayback.h"
+#include "ai/autopilot.h"
+#include "ai/versusgame.h"
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/signal_set.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace {
+
+std::optional<InputEvent> input_event(int key)
+{
+	using namespace tui;
+
+	switch (key)
+	{
+	case static_cast<int>(KeyCode::LEFT):
+		return InputEvent::MOVE_LEFT;
+	case static_cast<int>(KeyCode::RIGHT):
+		return InputEvent::MOVE_RIGHT;
+	case static_cast<int>(KeyCode::DOWN):
+		return InputEvent::SOFT_DROP;
+	case static_cast<int>(KeyCode::SPACE):
+		return InputEvent::HARD_DROP;
+	case static_cast<int>(KeyCode::UP):
+	case 'X':
+	case 'x':
+		return InputEvent::ROTATE_CLOCKWISE;
+	case 'Z':
+	case 'z':
+		return InputEvent::ROTATE_COUNTER_CLOCKWISE;
+	case static_cast<int>(KeyCode::F1):
+		return InputEvent::NEW_GAME;
+	}
+	return std::nullopt;
+}
+
+} // namespace
+
 class TuiApp::impl final
 {
 	boost::asio::io_context ioc_;
 	tui::AsioTerminal       terminal_;
 	Game                    game_;
+	ai::Autopilot           autopilot_;
+
+	std::unique_ptr<ReplayPlayback> playback_{};
+	std::unique_ptr<ai::VersusGame> versus_{};
+	std::vector<const Board*>       versusBoards_{};
 
 	void update()
 	{
-		tui::BoardRenderer::render(this->game_.board(), this->terminal_);
+		if (this->versus_)
+		{
+			return tui::BoardRenderer::render(this->versusBoards_, this->terminal_);
+		}
+		tui::BoardRenderer::render(this->playback_ ? this->playback_->board() : this->game_.board(), this->terminal_);
 	}
 
 public:
@@ -27,6 +75,7 @@ public:
 	    : ioc_{}
 	    , terminal_{ this->ioc_ }
 	    , game_{ [&]() { this->update(); }, std::make_unique<tui::Timer>(this->ioc_) }
+	    , autopilot_{ this->game_, std::make_unique<tui::Timer>(this->ioc_) }
 	{
 		this->terminal_.cursor(false);
 
@@ -40,25 +89,34 @@ public:
 
 			key &= ~(SHIFT | CONTROL | ALT | META);
 
-			switch (key)
+			if (this->playback_)
+			{
+				const auto frame = this->playback_->frame();
+				switch (key)
+				{
+				case static_cast<int>(KeyCode::LEFT):
+					return this->playback_->seek(frame - std::min(frame, ReplayPlayback::SEEK_STEP));
+				case static_cast<int>(KeyCode::RIGHT):
+					return this->playback_->seek(frame + ReplayPlayback::SEEK_STEP);
+				}
+				return;
+			}
+
+			const auto event = input_event(key);
+			if (this->versus_)
+			{
+				if (event)
+				{
+					this->versus_->processInputEvent(*event);
+				}
+			}
+			else if (event)
 			{
-			case static_cast<int>(KeyCode::LEFT):
-				return this->game_.processInputEvent(InputEvent::MOVE_LEFT);
-			case static_cast<int>(KeyCode::RIGHT):
-				return this->game_.processInputEvent(InputEvent::MOVE_RIGHT);
-			case static_cast<int>(KeyCode::DOWN):
-				return this->game_.processInputEvent(InputEvent::SOFT_DROP);
-			case static_cast<int>(KeyCode::SPACE):
-				return this->game_.processInputEvent(InputEvent::HARD_DROP);
-			case static_cast<int>(KeyCode::UP):
-			case 'X':
-			case 'x':
-				return this->game_.processInputEvent(InputEvent::ROTATE_CLOCKWISE);
-			case 'Z':
-			case 'z':
-				return this->game_.processInputEvent(InputEvent::ROTATE_COUNTER_CLOCKWISE);
-			case static_cast<int>(KeyCode::F1):
-				return this->game_.processInputEvent(InputEvent::NEW_GAME);
+				this->game_.processInputEvent(*event);
+			}
+			else if (key == static_cast<int>(KeyCode::F2))
+			{
+				this->autopilot_.toggle();
 			}
 		});
 	}
@@ -73,12 +131,43 @@ public:
 			this->ioc_.stop();
 		});
 
-		this->game_.start();
+		if (this->versus_)
+		{
+			this->versus_->start();
+		}
+		else if (this->playback_)
+		{
+			this->playback_->start();
+		}
+		else
+		{
+			this->game_.start();
+		}
 
 		this->ioc_.run();
 
+		if (const auto replay = this->game_.replay(); replay && !replay->inputs.empty())
+		{
+			replay->archive();
+		}
 		return 0;
 	}
+
+	void play(std::shared_ptr<const ReplayFile> replay, double speed)
+	{
+		auto timer      = std::make_unique<tui::Timer>(this->ioc_);
+		this->playback_ = std::make_unique<ReplayPlayback>(std::move(replay), [&]() { this->update(); }, std::move(timer), speed);
+	}
+
+	void playVersus(const ai::VersusGame::Options& options)
+	{
+		auto timer    = std::make_unique<tui::Timer>(this->ioc_);
+		this->versus_ = std::make_unique<ai::VersusGame>(options, [&]() { this->update(); }, std::move(timer));
+		for (size_t i = 0; i < this->versus_->boards(); ++i)
+		{
+			this->versusBoards_.push_back(&this->versus_->board(i));
+		}
+	}
 };
 
 TuiApp::TuiApp()
@@ -86,6 +175,18 @@ TuiApp::TuiApp()
 {
 }
 
+TuiApp::TuiApp(std::shared_ptr<const ReplayFile> replay, double speed)
+    : pimpl_{ std::make_unique<impl>() }
+{
+	this->pimpl_->play(std::move(replay), speed);
+}
+
+TuiApp::TuiApp(const ai::VersusGame::Options& options)
+    : pimpl_{ std::make_unique<impl>() }
+{
+	this->pimpl_->playVersus(options);
+}
+
 TuiApp::~TuiApp() noexcept
 {
 }
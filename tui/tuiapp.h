@@ -1,7 +1,11 @@
 #pragma once
 
+#include "ai/versusgame.h"
+
 #include <memory>
 
+class ReplayFile;
+
 class TuiApp final
 {
 	class impl;
@@ -9,6 +13,10 @@ class TuiApp final
 
 public:
 	TuiApp();
+	// Plays the replay back instead of a game. The arrow keys seek.
+	TuiApp(std::shared_ptr<const ReplayFile> replay, double speed);
+	// Plays a versus match against AI opponents instead of a game.
+	explicit TuiApp(const ai::VersusGame::Options& options);
 	~TuiApp() noexcept;
 
 	int run();
@@ -0,0 +1,304 @@
+#include "versus.h"
+#include "board.h"
+#include "grid.h"
+#include "inputevent.h"
+#include "threadpool.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+
+std::string VersusReport::summary() const
+{
+	std::string result = fmt::format("{} matches of {} boards on {} threads in {:.2f} s, {:.2f} matches/s\n",
+	                                  this->matches,
+	                                  this->boards,
+	                                  this->threads,
+	                                  this->seconds,
+	                                  static_cast<double>(this->matches) / this->seconds);
+	result += "wins";
+	for (size_t i = 0; i < this->wins.size(); ++i)
+	{
+		result += fmt::format("   board {}: {}", i, this->wins[i]);
+	}
+	result += fmt::format("   undecided {}\n", this->undecided);
+	result += fmt::format("minutes per match      mean {:.2f}  p10 {:.2f}  p50 {:.2f}  p90 {:.2f}  max {:.2f}\n",
+	                      this->minutes.mean,
+	                      this->minutes.p10,
+	                      this->minutes.p50,
+	                      this->minutes.p90,
+	                      this->minutes.max);
+	result += fmt::format("garbage rows a minute  mean {:.1f}  p10 {:.1f}  p50 {:.1f}  p90 {:.1f}  max {:.1f}   all boards together\n",
+	                      this->garbage.mean,
+	                      this->garbage.p10,
+	                      this->garbage.p50,
+	                      this->garbage.p90,
+	                      this->garbage.max);
+	result += fmt::format("us per frame           mean {:.1f}  p50 {:.1f}  p90 {:.1f}  max {:.1f}   {:.0f}x real time\n",
+	                      this->frameTime.mean,
+	                      this->frameTime.p50,
+	                      this->frameTime.p90,
+	                      this->frameTime.max,
+	                      1e6 / Simulation::FRAMES_PER_SECOND / this->frameTime.mean);
+	return result;
+}
+
+std::array<int, 5> Versus::Options::parseGarbage(const std::string& list)
+{
+	std::array<int, 5> garbage{};
+	size_t             count{};
+	for (size_t begin = 0; begin <= list.size(); ++count)
+	{
+		const auto end  = std::min(list.find(',', begin), list.size());
+		const auto rows = list.substr(begin, end - begin);
+		if (count == garbage.size() || rows.empty() || rows.size() > 2 || rows.find_first_not_of("0123456789") != std::string::npos)
+		{
+			throw std::invalid_argument{ "garbage needs the rows for clearing 0, 1, 2, 3 and 4 lines, like 0,0,1,2,4" };
+		}
+		garbage[count] = std::stoi(rows);
+		begin          = end + 1;
+	}
+	if (count != garbage.size())
+	{
+		throw std::invalid_argument{ "garbage needs the rows for clearing 0, 1, 2, 3 and 4 lines, like 0,0,1,2,4" };
+	}
+	return garbage;
+}
+
+void GarbageQueue::push(int rows)
+{
+	this->attacks_.push_back(rows);
+}
+
+void GarbageQueue::clear()
+{
+	this->attacks_.clear();
+}
+
+int GarbageQueue::rows() const
+{
+	return std::accumulate(this->attacks_.begin(), this->attacks_.end(), 0);
+}
+
+int GarbageQueue::cancel(int rows)
+{
+	while (rows > 0 && !this->attacks_.empty())
+	{
+		const auto cancelled = std::min(rows, this->attacks_.front());
+		rows -= cancelled;
+		this->attacks_.front() -= cancelled;
+		if (this->attacks_.front() == 0)
+		{
+			this->attacks_.pop_front();
+		}
+	}
+	return rows;
+}
+
+void GarbageQueue::raise(Simulation& simulation, Xoshiro256& holes)
+{
+	for (; !this->attacks_.empty() && !simulation.board().gameOver(); this->attacks_.pop_front())
+	{
+		const auto rise = std::min(this->attacks_.front(), Grid::height());
+		simulation.raiseGarbage(rise, static_cast<int>(holes.below(Grid::width())));
+	}
+}
+
+void Versus::locked(size_t board, int linesCleared)
+{
+	auto& player = this->players_[board];
+
+	const auto rows = player.incoming.cancel(this->options_.garbage[linesCleared]);
+	if (rows > 0)
+	{
+		// The boards after the last target in turn, which comes back round to it, but not to the attacker.
+		for (size_t i = 1; i <= this->players_.size(); ++i)
+		{
+			const auto target = (player.target + i) % this->players_.size();
+			if (target != board && !this->players_[target].simulation.board().gameOver())
+			{
+				this->players_[target].incoming.push(rows);
+				player.target = target;
+				player.sent += rows;
+				break;
+			}
+		}
+	}
+
+	if (linesCleared == 0)
+	{
+		player.incoming.raise(player.simulation, player.holes);
+	}
+}
+
+Versus::Versus(size_t boards, const Options& options, std::function<void()> onUpdate)
+    : options_{ options }
+{
+	assert(boards >= 2);
+	this->players_.reserve(boards);
+	for (size_t i = 0; i < boards; ++i)
+	{
+		this->players_.push_back(Player{ Simulation{ onUpdate }, Xoshiro256{ 0 } });
+		this->players_.back().simulation.setLockHandler([this, i](int linesCleared) { this->locked(i, linesCleared); });
+	}
+}
+
+void Versus::start(uint64_t seed)
+{
+	this->frame_ = 0;
+	for (size_t i = 0; i < this->players_.size(); ++i)
+	{
+		auto& player  = this->players_[i];
+		player.holes  = Xoshiro256{ seed + 1 + i };
+		player.target = i;
+		player.sent   = 0;
+		player.incoming.clear();
+		player.simulation.start(seed);
+	}
+}
+
+size_t Versus::size() const
+{
+	return this->players_.size();
+}
+
+const Board& Versus::board(size_t board) const
+{
+	return this->players_[board].simulation.board();
+}
+
+const GameState& Versus::state(size_t board) const
+{
+	return this->players_[board].simulation.state();
+}
+
+int Versus::incoming(size_t board) const
+{
+	return this->players_[board].incoming.rows();
+}
+
+uint64_t Versus::sent(size_t board) const
+{
+	return this->players_[board].sent;
+}
+
+uint64_t Versus::frame() const
+{
+	return this->frame_;
+}
+
+void Versus::processInputEvent(size_t board, InputEvent event)
+{
+	if (event != InputEvent::NEW_GAME)
+	{
+		this->players_[board].simulation.processInputEvent(event);
+	}
+}
+
+void Versus::advanceTo(uint64_t frame)
+{
+	assert(frame >= this->frame_);
+	while (this->frame_ < frame)
+	{
+		++this->frame_;
+		for (auto& player : this->players_)
+		{
+			player.simulation.advanceTo(this->frame_);
+		}
+	}
+}
+
+bool Versus::over() const
+{
+	const auto playing = std::count_if(this->players_.begin(), this->players_.end(), [](const Player& player) {
+		return !player.simulation.board().gameOver();
+	});
+	return playing <= 1;
+}
+
+std::optional<size_t> Versus::winner() const
+{
+	if (!this->over())
+	{
+		return std::nullopt;
+	}
+	for (size_t i = 0; i < this->players_.size(); ++i)
+	{
+		if (!this->players_[i].simulation.board().gameOver())
+		{
+			return i;
+		}
+	}
+	return std::nullopt;
+}
+
+void Versus::play(uint64_t seed, const std::vector<Controller>& controllers, uint64_t maxFrames)
+{
+	assert(controllers.size() == this->players_.size());
+	this->start(seed);
+	while (!this->over() && this->frame_ < maxFrames)
+	{
+		this->advanceTo(this->frame_ + 1);
+		for (size_t i = 0; i < controllers.size(); ++i)
+		{
+			if (const auto input = controllers[i](this->state(i)))
+			{
+				this->processInputEvent(i, *input);
+			}
+		}
+	}
+}
+
+VersusReport Versus::run(ThreadPool& pool, const Matches& matches, const Options& options, const ControllerFactory& controllerFactory)
+{
+	std::vector<std::optional<size_t>> winners(matches.count);
+	std::vector<double>                minutes(matches.count), garbage(matches.count), frameTimes(matches.count);
+
+	const auto started = std::chrono::steady_clock::now();
+	pool.parallelFor(matches.count, [&](size_t match) {
+		const auto seed = BatchRunner::gameSeed(matches.seed, match);
+
+		Versus                  versus{ matches.boards, options };
+		std::vector<Controller> controllers{};
+		for (size_t i = 0; i < matches.boards; ++i)
+		{
+			controllers.push_back(controllerFactory(seed + i));
+		}
+
+		const auto matchStarted = std::chrono::steady_clock::now();
+		versus.play(seed, controllers, matches.maxFrames);
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - matchStarted).count();
+
+		winners[match]    = versus.winner();
+		minutes[match]    = static_cast<double>(versus.frame()) / Simulation::FRAMES_PER_SECOND / 60;
+		frameTimes[match] = seconds * 1e6 / static_cast<double>(std::max<uint64_t>(versus.frame(), 1));
+		for (size_t i = 0; i < matches.boards; ++i)
+		{
+			garbage[match] += static_cast<double>(versus.sent(i));
+		}
+		garbage[match] /= std::max(minutes[match], 1.0 / 60);
+	});
+
+	VersusReport report{};
+	report.matches = matches.count;
+	report.boards  = matches.boards;
+	report.threads = pool.size();
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+	report.wins.resize(matches.boards);
+	for (const auto& winner : winners)
+	{
+		if (winner)
+		{
+			++report.wins[*winner];
+		}
+	}
+	report.undecided = matches.count - std::accumulate(report.wins.begin(), report.wins.end(), uint64_t{});
+	report.minutes   = Distribution::of(minutes);
+	report.garbage   = Distribution::of(garbage);
+	report.frameTime = Distribution::of(frameTimes);
+	return report;
+}
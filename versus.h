@@ -0,0 +1,140 @@
+#pragma once
+
+#include "batchrunner.h"
+#include "simulation.h"
+#include "xoshiro256.h"
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Board;
+class ThreadPool;
+enum class InputEvent;
+
+struct VersusReport final
+{
+	size_t                matches;
+	size_t                boards;
+	unsigned              threads;
+	double                seconds;
+	std::vector<uint64_t> wins; // per board
+	uint64_t              undecided;
+	Distribution          minutes;   // per match
+	Distribution          garbage;   // rows a minute, all boards of a match together
+	Distribution          frameTime; // microseconds to step all boards of a match by one frame
+
+	std::string summary() const;
+};
+
+// The garbage waiting to rise on a board, as rows per attack, oldest first. The attacks of the board cancel it first,
+// and it rises when the board locks a tetromino without clearing a line, an attack at a time, each with a hole column of
+// its own, until it is gone or the board tops out.
+class GarbageQueue final
+{
+	std::deque<int> attacks_{};
+
+public:
+	void push(int rows);
+	void clear();
+
+	int rows() const;
+
+	// Takes the rows of an attack of the board off those waiting, and returns what is left to send on.
+	int cancel(int rows);
+
+	// Raises what is waiting onto the board, drawing the hole columns from holes.
+	void raise(Simulation& simulation, Xoshiro256& holes);
+};
+
+// Several games on one frame clock, in which clearing lines sends garbage to an opponent. Every board is dealt the same
+// tetrominoes. An attack first cancels the garbage waiting to rise on the attacker's own board, and the rest goes to the
+// next opponent still playing, in turn. Garbage waits until its board locks a tetromino without clearing a line, then
+// rises with a hole column of its own per attack, drawn from the board's own generator.
+//
+// The boards step through the frames together, in board order within a frame, so garbage sent during a frame reaches the
+// boards after the sender in that frame and the others in the next, and a match is fully determined by its seed and the
+// inputs at their frames, like a single game.
+class Versus final
+{
+public:
+	struct Options final
+	{
+		// Rows of garbage sent for clearing 0, 1, 2, 3 and 4 lines with one tetromino.
+		std::array<int, 5> garbage = { 0, 0, 1, 2, 4 };
+
+		// Takes the rows from a list like "0,0,1,2,4". Throws std::invalid_argument when it does not hold five counts.
+		static std::array<int, 5> parseGarbage(const std::string& list);
+	};
+
+	// Makes the input to play at the frame of the state, when one is due.
+	using Controller        = std::function<std::optional<InputEvent>(const GameState& state)>;
+	using ControllerFactory = std::function<Controller(uint64_t seed)>;
+
+	struct Matches final
+	{
+		size_t   boards    = 2;
+		size_t   count     = 100;
+		uint64_t seed      = 1;
+		uint64_t maxFrames = 10 * 60 * Simulation::FRAMES_PER_SECOND; // a match still going by then is undecided
+	};
+
+private:
+	struct Player final
+	{
+		Simulation   simulation;
+		Xoshiro256   holes;
+		GarbageQueue incoming{};
+		size_t       target{}; // of the next attack, if still playing
+		uint64_t     sent{};
+	};
+
+	Options             options_;
+	std::vector<Player> players_{};
+	uint64_t            frame_{};
+
+	void locked(size_t board, int linesCleared);
+
+public:
+	// At least two boards. Calls onUpdate whenever any board changes.
+	Versus(size_t boards, const Options& options, std::function<void()> onUpdate = {});
+
+	// The lock handlers refer back to the match.
+	Versus(const Versus&)            = delete;
+	Versus& operator=(const Versus&) = delete;
+
+	void start(uint64_t seed);
+
+	size_t size() const;
+
+	const Board&     board(size_t board) const;
+	const GameState& state(size_t board) const;
+
+	// Rows of garbage waiting to rise on the board, and sent from it so far.
+	int      incoming(size_t board) const;
+	uint64_t sent(size_t board) const;
+
+	uint64_t frame() const;
+
+	// At the current frame. A match is not restarted by NEW_GAME, but by start().
+	void processInputEvent(size_t board, InputEvent event);
+
+	void advanceTo(uint64_t frame);
+
+	// Whether at most one board is still playing.
+	bool over() const;
+	// The board still playing when all others topped out.
+	std::optional<size_t> winner() const;
+
+	// Starts a match with the seed and plays it headless, a controller per board, until it is over or reaches maxFrames.
+	void play(uint64_t seed, const std::vector<Controller>& controllers, uint64_t maxFrames);
+
+	// Plays many headless matches in parallel. Match i is seeded from the base seed and i, as a batch game is, and its
+	// board j is played by a controller made with the match seed plus j.
+	static VersusReport run(ThreadPool& pool, const Matches& matches, const Options& options, const ControllerFactory& controllerFactory);
+};
@@ -0,0 +1,72 @@
+#include "xoshiro256.h"
+#include "splitmix64.h"
+
+#include <cassert>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<Xoshiro256>::value, "");
+
+namespace {
+
+constexpr uint64_t rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+} // namespace
+
+Xoshiro256::Xoshiro256(uint64_t seed)
+    : state_{}
+{
+	this->seed(seed);
+}
+
+Xoshiro256::Xoshiro256(const State& state)
+    : state_{ state }
+{
+}
+
+Xoshiro256::result_type Xoshiro256::operator()()
+{
+	auto& s = this->state_;
+
+	const auto result = rotl(s[1] * 5, 7) * 9;
+	const auto t      = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+
+	s[2] ^= t;
+
+	s[3] = rotl(s[3], 45);
+
+	return result;
+}
+
+uint32_t Xoshiro256::below(uint32_t bound)
+{
+	assert(bound > 0);
+	// Lemire's multiply-shift reduction. The bias is below 2^-32 for the small bounds used here.
+	return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+}
+
+void Xoshiro256::seed(uint64_t seed)
+{
+	// Expands the seed into well mixed state words, as recommended by the xoshiro authors.
+	for (auto& word : this->state_)
+	{
+		word = splitmix64(seed);
+	}
+}
+
+const Xoshiro256::State& Xoshiro256::state() const
+{
+	return this->state_;
+}
+
+void Xoshiro256::setState(const State& state)
+{
+	this->state_ = state;
+}
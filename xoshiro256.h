@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** by David Blackman and Sebastiano Vigna (https://prng.di.unimi.it/). Small, fast, and fully determined by
+// its 32 bytes of state, which makes it cheap to seed, copy, save and restore. Satisfies UniformRandomBitGenerator.
+class Xoshiro256 final
+{
+public:
+	using result_type = uint64_t;
+	using State       = std::array<uint64_t, 4>;
+
+private:
+	State state_;
+
+public:
+	explicit Xoshiro256(uint64_t seed);
+	explicit Xoshiro256(const State& state);
+
+	static constexpr result_type min()
+	{
+		return std::numeric_limits<result_type>::min();
+	}
+
+	static constexpr result_type max()
+	{
+		return std::numeric_limits<result_type>::max();
+	}
+
+	result_type operator()();
+
+	// Uniformly distributed in [0, bound), computed the same way on every platform (unlike std::uniform_int_distribution).
+	uint32_t below(uint32_t bound);
+
+	void seed(uint64_t seed);
+
+	const State& state() const;
+	void         setState(const State& state);
+};
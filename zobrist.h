@@ -0,0 +1,22 @@
+#pragma once
+
+#include "splitmix64.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Zobrist hashing: every feature of a position (an occupied cell, a tetromino type, ...) gets a random key, and the hash of
+// a position is the XOR of the keys of its features. Changing one feature updates the hash with one XOR.
+//
+// The keys are generated at compile time from fixed seeds, so hashes are the same in every build and on every platform.
+template<size_t N>
+constexpr std::array<uint64_t, N> zobrist_keys(uint64_t seed)
+{
+	std::array<uint64_t, N> keys{};
+	for (auto& key : keys)
+	{
+		key = splitmix64(seed);
+	}
+	return keys;
+}